@@ -1,24 +1,95 @@
+#include <algorithm>
 #include <cmath>
 #include <iostream>
+#include <thread>
 
 #include "Board.h"
+#include "Hexagon.h"
+#include "Tween.h"
 #include "pallete.h"
 #include "ai.h"
 
 namespace {
     int outlineThickness = 3;
     float animation_duration = 0.2f;
+
+    // The computer searches while its move is held back this long after the player's.
+    float aiMoveDelay = 0.85f;
+    int aiThinkTimeMs = 850;
+
+    // mapped once and shared by every game; null when the file is missing
+    std::shared_ptr<const OpeningBook> openingBook() {
+        static std::shared_ptr<const OpeningBook> book = [] {
+            auto opened = std::make_shared<OpeningBook>();
+            return opened->open("assets/opening.book") ? opened : nullptr;
+        }();
+        return book;
+    }
+
+    // tuned weights when the file is there, the built-in ones otherwise
+    const EvalWeights& evalWeights() {
+        static EvalWeights weights = readEvalWeights("assets/eval.weights").value_or(EvalWeights());
+        return weights;
+    }
+
+    // assets/board.layout replaces the standard board when it is there
+    const BoardLayout& startingLayout() {
+        static BoardLayout layout = readLayoutFile("assets/board.layout").value_or(standardLayout());
+        return layout;
+    }
+
+    // a trained network replaces the weighted evaluation when one is installed
+    std::shared_ptr<const NnueNetwork> network() {
+        static std::shared_ptr<const NnueNetwork> loaded = NnueNetwork::load("assets/eval.nnue");
+        return loaded;
+    }
+}
+
+Cell::~Cell() {
+    tweens().cancel(this, sizeof(Cell));
 }
 
-void Cell::draw() {
-    window->draw(bgHexagon);
-    window->draw(outerHexagon);
-    window->draw(innerHexagon);
+void Cell::writeVertices(sf::Vertex* vertices) {
+    struct Layer {
+        float radius;
+        sf::Color color;
+    };
+    const Layer layers[3] = {
+        {35 * scale, Palette::Surface0},
+        {hexagon_size * scale * growth, outerColor()},
+        {(hexagon_size - indents) * scale * growth, currentColor},
+    };
+
+    sf::Vector2f center(globalX, globalY);
+    for (const Layer& layer : layers) {
+        sf::Vector2f corners[6];
+        for (int i = 0; i < 6; ++i) {
+            corners[i] = center + UnitHexagon::corners[i] * layer.radius;
+        }
+        // a convex hexagon is four triangles fanned out from its first corner
+        for (int i = 1; i < 5; ++i) {
+            *vertices++ = {corners[0], layer.color};
+            *vertices++ = {corners[i], layer.color};
+            *vertices++ = {corners[i + 1], layer.color};
+        }
+    }
+    dirty = false;
+}
+
+sf::Color Cell::outerColor() const {
+    switch (highlightState) {
+        case HighlightState::Selected:
+            return Palette::selectedCell;
+        case HighlightState::AvailableForCloning:
+            return Palette::Sky;
+        case HighlightState::AvailableForMoving:
+            return Palette::Green;
+        case HighlightState::None:
+            break;
+    }
+    return currentColor;
 }
 
-void Cell::setWindow(sf::RenderWindow* window) {
-    this->window = window;
-};
 void Cell::setPosition(int x, int y) {
     this->x = x;
     this->y = y;
@@ -27,85 +98,38 @@ void Cell::setGlobalPosition(int x, int y) {
     this->globalX = x;
     this->globalY = y;
 }
+void Cell::setScale(float scale) {
+    this->scale = scale;
+}
 void Cell::setState(CellState state) {
     this->state = state;
 }
 
 void Cell::initShapes() {
-    outerHexagon.setPointCount(6);
-    innerHexagon.setPointCount(6);
-    bgHexagon.setPointCount(6);
-
-    for (int i = 0; i < 6; ++i) {
-        float angle = i * 2 * 3.14159f / 6;
-        outerHexagon.setPoint(i, {globalX + hexagon_size * static_cast<float>(cos(angle)), globalY + hexagon_size * static_cast<float>(sin(angle))});
-        innerHexagon.setPoint(i, {globalX + (hexagon_size - indents) * static_cast<float>(cos(angle)), globalY + (hexagon_size - indents) * static_cast<float>(sin(angle))});
-        bgHexagon.setPoint(i, {globalX + 35 * static_cast<float>(cos(angle)), globalY + 35 * static_cast<float>(sin(angle))});
-    }
+    dirty = true;
 
     setColors(state);
 }
 
-void Cell::ifHovered(const sf::Vector2f& mousePos) {
-    hovered = isHovered(mousePos);
-
-    if (hovered != oldHoveredState) {
-        oldColor = currentColor;
-        animationTime = 0.0f;
-        targetColor = hovered ? hoverColor : normalColor;
-        oldHoveredState = hovered;
+void Cell::setHovered(bool hovered) {
+    if (hovered != this->hovered) {
+        this->hovered = hovered;
+        tweens().colors.start(&currentColor, hovered ? hoverColor : normalColor, animation_duration, &dirty);
     }
 }
 
-void Cell::update(float dt) {
-    animationTime += dt;
-    float t = animationTime / animation_duration;
-
-    if (t > 1.0f) {
-        t = 1.0f;
-        sf::Color oldTargetColor = targetColor;
-        sf::Color oldOuterColor = outerHexagon.getFillColor();
-        setColors(state);
-        targetColor = oldTargetColor;
-        outerHexagon.setFillColor(oldOuterColor);
-    }
-
-    currentColor.r = (int)((1 - t) * oldColor.r + t * targetColor.r);
-    currentColor.g = (int)((1 - t) * oldColor.g + t * targetColor.g);
-    currentColor.b = (int)((1 - t) * oldColor.b + t * targetColor.b);
-
-    if (highlightState == HighlightState::None)
-        outerHexagon.setFillColor(currentColor);
-    
-    innerHexagon.setFillColor(currentColor);
-
-    if (isAnimating) {
-        animationDuration += dt;
-        t = animationDuration / animation_duration;
-        if (t > 1.0f) {
-            t = 1.0f;
-            isAnimating = false;
-        } else if (t < 0.0f) {
-            t = 0.0f;
-        }
-
-        int newIndents = (int)(1 - t) * oldIndent + t * targetIndent;
-        int newSize = (int)(1 - t) * oldSize + t * targetSize;
-
-        setIndentsAndSize(newIndents, newSize);
-    }
+void Cell::startSpawnAnimation() {
+    growth = 0.0f;
+    tweens().scalars.start(&growth, 1.0f, animation_duration, &dirty);
 }
 
-void Cell::startAnimation(int targetIndent, int targetSize) {
-    this->targetIndent = targetIndent;
-    this->targetSize = targetSize;
-    animationDuration = 0.0f;
-    isAnimating = true;
-    oldIndent = indents;
-    oldSize = hexagon_size;
+void Cell::captureBy(CellState owner) {
+    state = owner;
+    pickColors(owner);
+    tweens().colors.start(&currentColor, hovered ? hoverColor : normalColor, animation_duration, &dirty);
 }
 
-void Cell::setColors(CellState state) {
+void Cell::pickColors(CellState state) {
     switch (state) {
         case CellState::Empty:
             normalColor = Palette::emptyColor;
@@ -124,88 +148,73 @@ void Cell::setColors(CellState state) {
             hoverColor = Palette::Background;
             break;
     }
-    
-    currentColor = normalColor;
-    oldColor = normalColor;
-    targetColor = normalColor;
-
-    outerHexagon.setFillColor(normalColor);
-    // outerHexagon.setOutlineThickness(outlineThickness);
-    // outerHexagon.setOutlineColor(Palette::Background);
+}
 
-    innerHexagon.setFillColor(normalColor);
+void Cell::setColors(CellState state) {
+    pickColors(state);
 
-    bgHexagon.setFillColor(Palette::Surface0);
+    tweens().colors.cancel(&currentColor, sizeof(currentColor));
+    currentColor = normalColor;
+    dirty = true;
 }
 
-bool Cell::isHovered(const sf::Vector2f& mousePos) {
-    float dx = mousePos.x - globalX;
-    float dy = mousePos.y - globalY;
-    float dist = std::sqrt(dx*dx + dy*dy);
-
-    return dist < hexagon_size;
+// Inside the flat top and bottom edges and under the four slanted ones, whose lines are
+// sqrt(3) * |dx| + |dy| = sqrt(3) * radius.
+bool Cell::contains(sf::Vector2f point) const {
+    float radius = hexagon_size * scale;
+    float dx = std::abs(point.x - globalX);
+    float dy = std::abs(point.y - globalY);
+    float root3 = 2 * UnitHexagon::halfRoot3;
+    return dy <= UnitHexagon::halfRoot3 * radius && root3 * dx + dy <= root3 * radius;
 }
 
 void Cell::setHighlightState(HighlightState state) {
-    if (state == HighlightState::None) {
-        outerHexagon.setFillColor(normalColor);
-    } else if (state == HighlightState::Selected) {
-        outerHexagon.setFillColor(Palette::selectedCell);
-    } else if (state == HighlightState::AvailableForCloning) {
-        outerHexagon.setFillColor(Palette::Sky);
-    } else if (state == HighlightState::AvailableForMoving) {
-        outerHexagon.setFillColor(Palette::Green);
-    }
-        
     highlightState = state;
+    dirty = true;
 }
 
 
 
 
-Board::Board(sf::RenderWindow& window, bool singleGame) : window(window) {
+Board::Board(sf::RenderWindow& window, bool singleGame, AiKind aiKind) : window(window) {
 
-    // 0 - empty, 1 - player1, 2 - player2, 3 - blocked
-    std::vector<int> board = {
-        3, 3, 3, 0, 2, 0, 3, 3, 3,
-        3, 0, 0, 0, 0, 0, 0, 0, 3,
-        1, 0, 0, 0, 0, 0, 0, 0, 1,
-        0, 0, 0, 0, 3, 0, 0, 0, 0,
-        0, 0, 0, 3, 0, 3, 0, 0, 0,
-        0, 0, 0, 0, 0, 0, 0, 0, 0,
-        2, 0, 0, 0, 0, 0, 0, 0, 2,
-        3, 3, 0, 0, 0, 0, 0, 3, 3,
-        3, 3, 3, 3, 1, 3, 3, 3, 3
-    };
+    setPosition(startingLayout().position);
 
-    cells.resize(9, std::vector<Cell>(9));
-    for (int row = 0; row < 9; row++) {
-        for (int col = 0; col < 9; col++) {
-            cells[row][col].setWindow(&window);
+    this->singleGame = singleGame;
+    this->aiKind = aiKind;
+
+    if (singleGame) {
+        int threads = std::max(1, static_cast<int>(std::thread::hardware_concurrency()) - 1);
+        ai = std::make_unique<AsyncSearch>(threads, TranspositionTable::defaultSizeMb, aiKind);
+        ai->setOpeningBook(openingBook());
+        ai->setEvalWeights(evalWeights());
+        ai->setNetwork(network());
+    }
+}
+
+void Board::setPosition(const Position& position) {
+    BoardLayout layout = layoutOf(position);
+    rows = layout.rows;
+    cols = layout.cols;
+
+    // larger layouts are scaled down to the room the standard 9x9 board takes
+    float scale = std::min({1.0f, 9.5f / (rows + 0.5f), 7.0f / (0.75f * (cols - 1) + 1)});
+
+    cells = std::vector<std::vector<Cell>>(BoardGeometry::rows, std::vector<Cell>(BoardGeometry::cols));
+    for (int row = 0; row < BoardGeometry::rows; row++) {
+        for (int col = 0; col < BoardGeometry::cols; col++) {
             cells[row][col].setPosition(col, row);
+            cells[row][col].setScale(scale);
             
-            switch (board[row * 9 + col]) {
-                case 0:
-                    cells[row][col].setState(CellState::Empty);
-                    break;
-                case 1:
-                    cells[row][col].setState(CellState::Player1);
-                    break;
-                case 2:
-                    cells[row][col].setState(CellState::Player2);
-                    break;
-                case 3:
-                    cells[row][col].setState(CellState::Blocked);
-                    break;
-            }
+            cells[row][col].setState(position.getState(cellIndex(row, col)));
             
-            int hexagon_size = 35 + outlineThickness*2;
+            float hexagon_size = (35 + outlineThickness*2) * scale;
 
             float hexWidth = hexagon_size * 2;
             float hexHeight = hexagon_size * sqrt(3);
 
-            int startBoardX = (window.getSize().x - hexagon_size * 9) / 2 - hexagon_size * 9 / 2 * 0.25f;
-            int startBoardY = (window.getSize().y - hexHeight * 9) / 2 + 37;
+            int startBoardX = (window.getSize().x - hexagon_size * cols) / 2 - hexagon_size * cols / 2 * 0.25f;
+            int startBoardY = (window.getSize().y - hexHeight * rows) / 2 + 37 * scale;
 
             int globalX = startBoardX + col * hexWidth;
             int globalY = startBoardY + row * hexHeight;
@@ -223,94 +232,149 @@ Board::Board(sf::RenderWindow& window, bool singleGame) : window(window) {
         }
     }
 
-    this->singleGame = singleGame;
+    float hexagon_size = (35 + outlineThickness*2) * scale;
+    columnStep = hexagon_size * 2 * 0.75f;
+    rowStep = hexagon_size * sqrt(3);
+    firstCenter = {static_cast<float>(cells[0][0].getGlobalX()), static_cast<float>(cells[0][0].getGlobalY())};
+    selectedCell = nullptr;
+    hoveredCell = nullptr;
+
+    vertices = sf::VertexArray(sf::PrimitiveType::Triangles, rows * cols * Cell::vertexCount);
 }
 
 void Board::draw() {
-    for (int row = 0; row < 9; row++) {
-        for (int col = 0; col < 9; col++) {
-            cells[row][col].draw();
+    // one batch for the whole board; cells rewrite their slice only when they changed
+    for (int row = 0; row < rows; row++) {
+        for (int col = 0; col < cols; col++) {
+            Cell& cell = cells[row][col];
+            if (cell.needsRedraw()) {
+                cell.writeVertices(&vertices[(row * cols + col) * Cell::vertexCount]);
+            }
         }
     }
+    window.draw(vertices);
 }
 
 void Board::handleEvent(const sf::Event& event) {
     if (const auto* mouseMoved = event.getIf<sf::Event::MouseMoved>()) {
-        for (auto& cellInRow : cells) {
-            for (auto& cell : cellInRow) {
-                cell.ifHovered({static_cast<float>(mouseMoved->position.x), 
+        // only the cells the pointer left and entered change
+        Cell* hovered = cellAt({static_cast<float>(mouseMoved->position.x), 
                                 static_cast<float>(mouseMoved->position.y)});
-            }
+        if (hovered != hoveredCell) {
+            if (hoveredCell != nullptr) hoveredCell->setHovered(false);
+            if (hovered != nullptr) hovered->setHovered(true);
+            hoveredCell = hovered;
         }
     } else if (const auto* mouseButton = event.getIf<sf::Event::MouseButtonPressed>()) { 
+        if (singleGame && !isPlayer1Turn) return;
+
         if (mouseButton->button == sf::Mouse::Button::Left) {
-            for (auto& cellInRow : cells) {
-                for (auto& cell : cellInRow) {
-                    if (cell.isHovered({static_cast<float>(mouseButton->position.x), 
-                                        static_cast<float>(mouseButton->position.y)})) {
-                        switch (cell.getHighlightState())
-                        {
-                            case HighlightState::None:
-                                selectCell(cell);
-                                if (selectedCell != nullptr) {
-                                    highlightAvailableForCloningCells();
-                                    highlightAvailableForMovingCells();
-                                }
-                                break;
-                            case HighlightState::Selected:
-                                cell.setHighlightState(HighlightState::None);
-                                clearHighlightedCells();
-                                break;
-                            case HighlightState::AvailableForCloning:
-                                cloneToCell(cell);
-                                
-                                if (singleGame) {
-                                    isPlayer1Turn = !isPlayer1Turn;
-                                    sleepTime = 0.0f;
-                                } else {
-                                    isPlayer1Turn = !isPlayer1Turn;
-                                    gameIsOver();
-                                }
-                                
-                                break;
-                            case HighlightState::AvailableForMoving:
-                                moveToCell(cell);
-                                
-                                if (singleGame) {
-                                    isPlayer1Turn = !isPlayer1Turn;
-                                    sleepTime = 0.0f;
-                                } else {
-                                    isPlayer1Turn = !isPlayer1Turn;
-                                    gameIsOver();
-                                }
-                                break;
-                        }                        
-                    }
+            Cell* clicked = cellAt({static_cast<float>(mouseButton->position.x), 
+                                    static_cast<float>(mouseButton->position.y)});
+            if (clicked != nullptr) {
+                Cell& cell = *clicked;
+                switch (cell.getHighlightState())
+                {
+                    case HighlightState::None:
+                        selectCell(cell);
+                        if (selectedCell != nullptr) {
+                            highlightAvailableForCloningCells();
+                            highlightAvailableForMovingCells();
+                        }
+                        break;
+                    case HighlightState::Selected:
+                        cell.setHighlightState(HighlightState::None);
+                        clearHighlightedCells();
+                        break;
+                    case HighlightState::AvailableForCloning:
+                        cloneToCell(cell);
+                    
+                        isPlayer1Turn = !isPlayer1Turn;
+                        sleepTime = 0.0f;
+                        // a move that leaves the computer stuck ends the game before it searches
+                        gameIsOver();
+                    
+                        break;
+                    case HighlightState::AvailableForMoving:
+                        moveToCell(cell);
+                    
+                        isPlayer1Turn = !isPlayer1Turn;
+                        sleepTime = 0.0f;
+                        gameIsOver();
+                        break;
                 }
             }
         }
     }
 }
 
-void Board::update(float dt) {
-    for (auto& cellInRow : cells) {
-        for (auto& cell : cellInRow) {
-            cell.update(dt);
+// Inverts the layout of setPosition: centres are columnStep apart across and rowStep down,
+// odd columns half a row lower. A hexagon reaches less than columnStep either side of its
+// centre, so only the nearest cells of the two columns around the point can contain it.
+Cell* Board::cellAt(sf::Vector2f point) {
+    int first = static_cast<int>(std::floor((point.x - firstCenter.x) / columnStep));
+    for (int col = first; col <= first + 1; col++) {
+        if (col < 0 || col >= cols) continue;
+
+        float shift = col % 2 == 1 ? rowStep / 2 : 0.0f;
+        int row = static_cast<int>(std::lround((point.y - firstCenter.y - shift) / rowStep));
+        if (row < 0 || row >= rows) continue;
+
+        if (cells[row][col].contains(point)) {
+            return &cells[row][col];
         }
     }
+    return nullptr;
+}
+
+void Board::update(float dt) {
+    if (isPlayer1Turn && singleGame && !isGameOver && pondering && !ponderStarted) {
+        ai->ponder(getPosition(), CellState::Player1);
+        ponderStarted = true;
+    }
+
+    if (!isPlayer1Turn && singleGame && !isGameOver) {
+        sleepTime += dt;
+        ponderStarted = false;
+
+        if (ai->isPondering()) {
+            ai->cancel();
+        }
+        if (!ai->isSearching() && !aiResult) {
+            ai->start(getPosition(), CellState::Player2, {maxSearchDepth, aiThinkTimeMs});
+        }
+        if (auto result = ai->poll()) {
+            aiResult = result;
+        }
 
-    if (!isPlayer1Turn && singleGame) {
-        if (sleepTime > 0.85f) {
-            doBestMove(*this);
+        if (aiResult && sleepTime > aiMoveDelay) {
+            if (aiResult->fromBook) {
+                std::cout << "Book move" << std::endl;
+            } else if (aiResult->solved) {
+                std::cout << "Solved, margin " << aiResult->score / pieceScore << ", nodes " << aiResult->nodes
+                          << " in " << aiResult->timeMs << " ms" << std::endl;
+            } else {
+                std::cout << "Depth " << aiResult->depth << ", score " << aiResult->score << ", nodes " << aiResult->nodes
+                          << " in " << aiResult->timeMs << " ms, hash hits " << aiResult->stats.ttHitRate() * 100 << "%" << std::endl;
+            }
+
+            playMove(aiResult->bestMove);
+            aiResult.reset();
             isPlayer1Turn = !isPlayer1Turn;
             gameIsOver();
             sleepTime = 0.0f;
-        } else {
-            sleepTime += dt;
         }
     }
 }
 
+void Board::cancelAi() {
+    if (ai) {
+        ai->cancel();
+    }
+    aiResult.reset();
+    ponderStarted = false;
+}
+
 void Board::setIsPlayer1Turn(bool isPlayer1Turn) {
     this->isPlayer1Turn = isPlayer1Turn;
 }
@@ -337,29 +401,15 @@ void Board::selectCell(Cell& cell) {
 void Board::highlightAvailableForCloningCells() {
     if (selectedCell == nullptr) return;
 
-    int x = selectedCell->getX();
-    int y = selectedCell->getY();
+    const CellTopology& topology = Topology::of(selectedCell->getY(), selectedCell->getX());
 
     std::vector<Cell*> availableCells;
 
-    if (y-1 >= 0 && cells[y-1][x].getState() == CellState::Empty) {
-        availableCells.push_back(&cells[y-1][x]);   
-    }
-    if (y+1 < 9 && cells[y+1][x].getState() == CellState::Empty) {
-        availableCells.push_back(&cells[y+1][x]);   
-    }
-    if (x+1 < 9 && cells[y][x+1].getState() == CellState::Empty) {
-        availableCells.push_back(&cells[y][x+1]);   
-    }
-    if (x-1 >= 0 && cells[y][x-1].getState() == CellState::Empty) {
-        availableCells.push_back(&cells[y][x-1]);   
-    }
-    int dy = (x % 2 == 0) ? -1 : 1;
-    if (y+dy >= 0 && y+dy < 9 && x-1 >= 0 && cells[y+dy][x-1].getState() == CellState::Empty) {
-        availableCells.push_back(&cells[y+dy][x-1]);   
-    }
-    if (y+dy >= 0 && y+dy < 9 && x+1 < 9 && cells[y+dy][x+1].getState() == CellState::Empty) {
-        availableCells.push_back(&cells[y+dy][x+1]);   
+    for (int i = 0; i < topology.neighborCount; i++) {
+        Cell& cell = cells[cellRow(topology.neighbors[i])][cellCol(topology.neighbors[i])];
+        if (cell.getState() == CellState::Empty) {
+            availableCells.push_back(&cell);
+        }
     }
 
     for (auto* cell : availableCells) {
@@ -373,43 +423,16 @@ void Board::highlightAvailableForCloningCells() {
 void Board::highlightAvailableForMovingCells() {
     if (selectedCell == nullptr) return;
 
-    int c_x = selectedCell->getX();
-    int c_y = selectedCell->getY();
+    const CellTopology& topology = Topology::of(selectedCell->getY(), selectedCell->getX());
 
     std::vector<Cell*> availableCells;
 
-    int dy;
-    for (int x = c_x-1; x <= c_x+1; x++)
-    {
-        if (x >= 0 && x < 9)
-        {
-            dy = (c_x % 2 == 0 && x % 2 == 1) ? 1 : 0;
-            if (c_y+2-dy < 9 && cells[c_y+2-dy][x].getState() == CellState::Empty)
-            {
-                availableCells.push_back(&cells[c_y+2-dy][x]);
-            }
-            dy = (c_x % 2 == 1 && x % 2 == 0) ? 1 : 0;
-            if (c_y-2+dy >= 0 && c_y-2+dy < 9 && cells[c_y-2+dy][x].getState() == CellState::Empty)
-            {
-                availableCells.push_back(&cells[c_y-2+dy][x]);
-            }
+    for (int i = 0; i < topology.jumpCount; i++) {
+        Cell& cell = cells[cellRow(topology.jumps[i])][cellCol(topology.jumps[i])];
+        if (cell.getState() == CellState::Empty) {
+            availableCells.push_back(&cell);
         }
     }
-    for (int y = c_y-1; y <= c_y+1; y++)
-    {
-        if (y >= 0 && y < 9)
-        {
-            if (c_x+2 < 9 && cells[y][c_x+2].getState() == CellState::Empty)
-            {
-                availableCells.push_back(&cells[y][c_x+2]);
-            }
-            if (c_x-2 >= 0 && cells[y][c_x-2].getState() == CellState::Empty)
-            {
-                availableCells.push_back(&cells[y][c_x-2]);
-            }
-        }
-    }
-    
 
     for (auto* cell : availableCells) {
         cell->setHighlightState(HighlightState::AvailableForMoving);
@@ -437,8 +460,7 @@ void Board::cloneToCell(Cell& cell) {
         
         capture(cell);
 
-        cell.setIndentsAndSize(0, 0);
-        cell.startAnimation(5, 35);
+        cell.startSpawnAnimation();
     }
 }
 
@@ -456,44 +478,26 @@ void Board::moveToCell(Cell& cell) {
         clearHighlightedCells();
         capture(cell);
 
-        cell.setIndentsAndSize(0, 0);
-        cell.startAnimation(5, 35);
+        cell.startSpawnAnimation();
     }
 }
 
 void Board::capture(Cell& cell) {
-    int x = cell.getX();
-    int y = cell.getY();
-    CellState target = cell.getState() == CellState::Player1 ? CellState::Player2 : CellState::Player1;
+    const CellTopology& topology = Topology::of(cell.getY(), cell.getX());
+    CellState owner = cell.getState();
+    CellState target = owner == CellState::Player1 ? CellState::Player2 : CellState::Player1;
 
     std::vector<Cell*> availableCells;
 
-    if (y-1 >= 0 && cells[y-1][x].getState() == target) {
-        availableCells.push_back(&cells[y-1][x]);
-    }
-    if (y+1 < 9 && cells[y+1][x].getState() == target) {
-        availableCells.push_back(&cells[y+1][x]);
-    }
-    if (x+1 < 9 && cells[y][x+1].getState() == target) {
-        availableCells.push_back(&cells[y][x+1]);
-    }
-    if (x-1 >= 0 && cells[y][x-1].getState() == target) {
-        availableCells.push_back(&cells[y][x-1]);
-    }
-    int dy = (x % 2 == 0) ? -1 : 1;
-    if (y+dy >= 0 && y+dy < 9 && x-1 >= 0 && cells[y+dy][x-1].getState() == target) {
-        availableCells.push_back(&cells[y+dy][x-1]);   
-    }
-    if (y+dy >= 0 && y+dy < 9 && x+1 < 9 && cells[y+dy][x+1].getState() == target) {
-        availableCells.push_back(&cells[y+dy][x+1]);   
+    for (int i = 0; i < topology.neighborCount; i++) {
+        Cell& neighbor = cells[cellRow(topology.neighbors[i])][cellCol(topology.neighbors[i])];
+        if (neighbor.getState() == target) {
+            availableCells.push_back(&neighbor);
+        }
     }
 
     for (auto* cell : availableCells) {
-        cell->oldColor = cell->currentColor;
-        cell->animationTime = 0.0f;
-        cell->targetColor = isPlayer1Turn ? Palette::p1Color : Palette::p2Color;
-        
-        cell->setState( isPlayer1Turn ? CellState::Player1 : CellState::Player2 );
+        cell->captureBy(owner);
     }
 }
 
@@ -503,13 +507,13 @@ void Board::clearHighlightedCells() {
     selectedCell = nullptr;
 }
 
-std::vector<Cell> Board::getCellsWithState(CellState state) const {
-    std::vector<Cell> playerCells;
+std::vector<const Cell*> Board::getCellsWithState(CellState state) const {
+    std::vector<const Cell*> playerCells;
 
     for (auto& cellInRow : cells) {
         for (auto& cell : cellInRow) {
             if (cell.getState() == state) {
-                playerCells.push_back(cell);
+                playerCells.push_back(&cell);
             }
         }
     }
@@ -517,18 +521,19 @@ std::vector<Cell> Board::getCellsWithState(CellState state) const {
 }
 
 void Board::gameIsOver() {
-    int p1CellsCount = getCellsWithState(CellState::Player1).size();
-    int p2CellsCount = getCellsWithState(CellState::Player2).size();
-    int emptyCellsCount = getCellsWithState(CellState::Empty).size();
+    Position position = getPosition();
+    int sideToMove = Position::side(isPlayer1Turn ? CellState::Player1 : CellState::Player2);
 
-    if (p1CellsCount == 0 || p2CellsCount == 0 || emptyCellsCount == 0) {
-        if (p1CellsCount > p2CellsCount) {
+    if (position.isGameOver(sideToMove)) {
+        if (position.finalMargin(sideToMove) > 0) {
             isPlayer1Win = true;
         } else {
             isPlayer1Win = false;
         }
 
         isGameOver = true;
+        // nothing is left to search or ponder
+        cancelAi();
     }
 }
 
@@ -559,157 +564,29 @@ int Board::moveFromTo(Cell& from, Cell& to) {
 }
 
 
+void Board::playMove(const Move& move) {
+    if (!move.isValid()) return;
 
-std::vector<std::pair<int, int>> BoardState::getCellsWithState(CellState state) const {
-    std::vector<std::pair<int, int>> playerCells;
+    std::cout << "Best move: " << cellRow(move.from) << ", " << cellCol(move.from)
+              << " to " << cellRow(move.to) << ", " << cellCol(move.to) << std::endl;
 
-    for (auto& cellInRow : cells) {
-        for (auto& cell : cellInRow) {
-            if (cell.getState() == state) {
-                playerCells.push_back(std::make_pair(cell.getY(), cell.getX()));
-            }
-        }
-    }
-    return playerCells;
-}
-
-std::vector<std::pair<int, int>> BoardState::getAvailableForCloningCells(int fromRow, int fromCol) const {
-    int x = fromCol;
-    int y = fromRow;
-
-    std::vector<std::pair<int, int>> availableCells;
+    Cell& from = cells[cellRow(move.from)][cellCol(move.from)];
+    Cell& to = cells[cellRow(move.to)][cellCol(move.to)];
 
-    if (y-1 >= 0 && cells[y-1][x].getState() == CellState::Empty) {
-        availableCells.push_back(std::make_pair(y-1, x));   
-    }
-    if (y+1 < 9 && cells[y+1][x].getState() == CellState::Empty) {
-        availableCells.push_back(std::make_pair(y+1, x));   
-    }
-    if (x+1 < 9 && cells[y][x+1].getState() == CellState::Empty) {
-        availableCells.push_back(std::make_pair(y, x+1));   
-    }
-    if (x-1 >= 0 && cells[y][x-1].getState() == CellState::Empty) {
-        availableCells.push_back(std::make_pair(y, x-1));   
-    }
-    int dy = (x % 2 == 0) ? -1 : 1;
-    if (y+dy >= 0 && y+dy < 9 && x-1 >= 0 && cells[y+dy][x-1].getState() == CellState::Empty) {
-        availableCells.push_back(std::make_pair(y+dy, x-1));   
-    }
-    if (y+dy >= 0 && y+dy < 9 && x+1 < 9 && cells[y+dy][x+1].getState() == CellState::Empty) {
-        availableCells.push_back(std::make_pair(y+dy, x+1));   
+    if (move.type == MoveType::Clone) {
+        cloneFromTo(from, to);
+    } else if (move.type == MoveType::Move) {
+        moveFromTo(from, to);
     }
-
-    return availableCells;
 }
 
-std::vector<std::pair<int, int>> BoardState::getAvailableForMovingCells(int fromRow, int fromCol) const {
-    int c_y = fromRow;
-    int c_x = fromCol;
-
-    std::vector<std::pair<int, int>> availableCells;
+Position Board::getPosition() const {
+    Position position;
 
-    int dy;
-    for (int x = c_x-1; x <= c_x+1; x++)
-    {
-        if (x >= 0 && x < 9)
-        {
-            dy = (c_x % 2 == 0 && x % 2 == 1) ? 1 : 0;
-            if (c_y+2-dy < 9 && cells[c_y+2-dy][x].getState() == CellState::Empty)
-            {
-                availableCells.push_back(std::make_pair(c_y+2-dy, x));
-            }
-            dy = (c_x % 2 == 1 && x % 2 == 0) ? 1 : 0;
-            if (c_y-2+dy >= 0 && c_y-2+dy < 9 && cells[c_y-2+dy][x].getState() == CellState::Empty)
-            {
-                availableCells.push_back(std::make_pair(c_y-2+dy, x));
-            }
-        }
-    }
-    for (int y = c_y-1; y <= c_y+1; y++)
-    {
-        if (y >= 0 && y < 9)
-        {
-            if (c_x+2 < 9 && cells[y][c_x+2].getState() == CellState::Empty)
-            {
-                availableCells.push_back(std::make_pair(y, c_x+2));
-            }
-            if (c_x-2 >= 0 && cells[y][c_x-2].getState() == CellState::Empty)
-            {
-                availableCells.push_back(std::make_pair(y, c_x-2));
-            }
+    for (auto& cellInRow : cells) {
+        for (auto& cell : cellInRow) {
+            position.setState(cellIndex(cell.getY(), cell.getX()), cell.getState());
         }
     }
-
-    return availableCells;
-}
-
-int BoardState::cloneFromTo(int fromRow, int fromCol, int toRow, int toCol) {
-    Cell& from = cells[fromRow][fromCol];
-    Cell& to = cells[toRow][toCol];
-
-    int oldCount = getCellsWithState(from.getState()).size();
-    
-    if (from.getState() == CellState::Player1) {
-        to.setState(CellState::Player1);
-    } else {
-        to.setState(CellState::Player2);
-    }
-
-    capture(to);
-
-    int newCount = getCellsWithState(to.getState()).size();
-    
-    return newCount - oldCount;
-}
-
-int BoardState::moveFromTo(int fromRow, int fromCol, int toRow, int toCol) {
-    Cell& from = cells[fromRow][fromCol];
-    Cell& to = cells[toRow][toCol];
-    
-    int oldCount = getCellsWithState(from.getState()).size();
-    
-    if (from.getState() == CellState::Player1) {
-        to.setState(CellState::Player1);
-    } else {
-        to.setState(CellState::Player2);
-    }
-    from.setState(CellState::Empty);
-    
-    capture(to);
-
-    int newCount = getCellsWithState(to.getState()).size();
-    
-    return newCount - oldCount;
-}
-
-void BoardState::capture(Cell& cell) {
-    int x = cell.getX();
-    int y = cell.getY();
-    CellState target = CellState::Player1;
-
-    std::vector<Cell*> availableCells;
-
-    if (y-1 >= 0 && cells[y-1][x].getState() == target) {
-        availableCells.push_back(&cells[y-1][x]);
-    }
-    if (y+1 < 9 && cells[y+1][x].getState() == target) {
-        availableCells.push_back(&cells[y+1][x]);
-    }
-    if (x+1 < 9 && cells[y][x+1].getState() == target) {
-        availableCells.push_back(&cells[y][x+1]);
-    }
-    if (x-1 >= 0 && cells[y][x-1].getState() == target) {
-        availableCells.push_back(&cells[y][x-1]);
-    }
-    int dy = (x % 2 == 0) ? -1 : 1;
-    if (y+dy >= 0 && y+dy < 9 && x-1 >= 0 && cells[y+dy][x-1].getState() == target) {
-        availableCells.push_back(&cells[y+dy][x-1]);   
-    }
-    if (y+dy >= 0 && y+dy < 9 && x+1 < 9 && cells[y+dy][x+1].getState() == target) {
-        availableCells.push_back(&cells[y+dy][x+1]);   
-    }
-
-    for (auto* cell : availableCells) {
-        cell->setState( CellState::Player2 );
-    }
+    return position;
 }
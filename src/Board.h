@@ -2,9 +2,13 @@
 
 #include <SFML/Graphics.hpp>
 
-#include "pallete.h"
+#include <memory>
+#include <optional>
 
-enum class CellState { Empty, Player1, Player2, Blocked };
+#include "pallete.h"
+#include "Layout.h"
+#include "Position.h"
+#include "AsyncSearch.h"
 enum class HighlightState { 
     None,
     Selected,
@@ -17,49 +21,57 @@ public:
     int hexagon_size = 35;
     int indents = 5;
 
+    // background, outer and inner hexagon, four triangles each
+    static constexpr int vertexCount = 3 * 4 * 3;
+
     Cell() : state(CellState::Empty), x(0), y(0) {};
+    // tweens() writes into live cells, so they are copied but never assigned over
+    Cell(const Cell&) = default;
+    Cell& operator=(const Cell&) = delete;
+    // drops the cell's running animations
+    ~Cell();
 
-    void draw();
+    // Whether the cell looks different from what it last wrote with writeVertices.
+    bool needsRedraw() const { return dirty; }
+    void writeVertices(sf::Vertex* vertices);
 
-    void setWindow(sf::RenderWindow* window);
     void setPosition(int x, int y);
     void setGlobalPosition(int x, int y);
+    // sizes stay in standard board units, scale shrinks them for larger layouts
+    void setScale(float scale);
     void setState(CellState state);
 
     void initShapes();
 
-    void ifHovered(const sf::Vector2f& mousePos);
-    void update(float dt);
+    // Fades between the normal and hover colour; animations run on tweens().
+    void setHovered(bool hovered);
 
-    bool isHovered(const sf::Vector2f& mousePos);
+    // Exact test against the outer hexagon.
+    bool contains(sf::Vector2f point) const;
 
     void setHighlightState(HighlightState state);
 
     int getX() const { return x; }
     int getY() const { return y; }
+    int getGlobalX() const { return globalX; }
+    int getGlobalY() const { return globalY; }
 
     CellState getState() const { return state; }
     HighlightState getHighlightState() { return highlightState; }
 
     void setColors(CellState state);
 
-    void startAnimation(int targetIndent, int targetSize);
-
-    void setIndentsAndSize(int indents, int size) {
-        this->indents = indents;
-        this->hexagon_size = size;
-        initShapes();
-    }
+    // Grows the piece out of the cell's centre.
+    void startSpawnAnimation();
+    // Takes the cell for owner and fades it to the owner's colour.
+    void captureBy(CellState owner);
 
     CellState state;
 
     sf::Color hoverColor;
     sf::Color normalColor;
     sf::Color currentColor;
-    sf::Color oldColor;
-    sf::Color targetColor;
- 
-    float animationTime = 0.0f;
+
 private:
 
 
@@ -68,22 +80,18 @@ private:
 
     int globalX;
     int globalY;
+    float scale = 1.0f;
 
-    sf::ConvexShape outerHexagon;
-    sf::ConvexShape innerHexagon;
-    sf::ConvexShape bgHexagon;
+    bool dirty = true;
 
-    sf::RenderWindow* window;
+    void pickColors(CellState state);
+    // the highlight colour, or the cell's own colour when it has none
+    sf::Color outerColor() const;
 
     bool hovered = false;
-    bool oldHoveredState = false;  
-    
-    bool isAnimating = false;
-    float animationDuration = 0.0f;
-    int targetIndent = indents;
-    int targetSize = hexagon_size;
-    int oldIndent = indents;
-    int oldSize = hexagon_size;
+
+    // scale of the outer and inner hexagon while the spawn animation runs
+    float growth = 1.0f;
 
     HighlightState highlightState = HighlightState::None;
 };
@@ -93,8 +101,27 @@ class Board
 {
 private:
     float sleepTime = 0;
+
+    // computer opponent, only in single player games
+    std::unique_ptr<AsyncSearch> ai;
+    std::optional<SearchResult> aiResult;
+    bool ponderStarted = false;
     
     sf::RenderWindow& window;
+    sf::VertexArray vertices;
+
+    // extent of the layout; cells of the grid beyond it are blocked and not drawn
+    int rows = 0;
+    int cols = 0;
+
+    // cell centres: the first one's and the steps between columns and rows
+    sf::Vector2f firstCenter;
+    float columnStep = 0;
+    float rowStep = 0;
+    Cell* hoveredCell = nullptr;
+
+    // The cell whose hexagon contains point, in constant time; nullptr between cells and off the board.
+    Cell* cellAt(sf::Vector2f point);
 
     void selectCell(Cell& cell);
 
@@ -116,7 +143,7 @@ private:
     void gameIsOver();
     
 public:
-    std::vector<Cell> getCellsWithState(CellState state) const;
+    std::vector<const Cell*> getCellsWithState(CellState state) const;
     
     std::vector<std::vector<Cell>> cells;
 
@@ -125,8 +152,14 @@ public:
     bool isGameOver = false;
     bool isPlayer1Win = false;
     bool singleGame = false;
+    AiKind aiKind = AiKind::Minimax;
+    // let the computer think on the player's time
+    bool pondering = true;
+
+    Board(sf::RenderWindow& window, bool singleGame, AiKind aiKind = AiKind::Minimax);
 
-    Board(sf::RenderWindow& window, bool singleGame);
+    // Lays the cells out for position's layout and sets their states.
+    void setPosition(const Position& position);
 
     void draw();
 
@@ -138,27 +171,11 @@ public:
 
     int cloneFromTo(Cell& from, Cell& to);
     int moveFromTo(Cell& from, Cell& to);
-};
-
+    void playMove(const Move& move);
 
-class BoardState {
-public:
-    BoardState(Board board) {
-        cells.resize(9, std::vector<Cell>(9));
-        for (int i = 0; i < 9; ++i) {
-            for (int j = 0; j < 9; ++j) {
-                cells[i][j] = board.cells[i][j];
-                cells[i][j].setState(board.cells[i][j].getState());
-            }
-        }
-    };
-
-    std::vector<std::vector<Cell>> cells;
+    // Stops the computer's search; it starts over on the next update of its turn.
+    void cancelAi();
 
-    std::vector<std::pair<int, int>> getCellsWithState(CellState state) const;
-    std::vector<std::pair<int, int>> getAvailableForCloningCells(int fromRow, int fromCol) const;
-    std::vector<std::pair<int, int>> getAvailableForMovingCells(int fromRow, int fromCol) const;
-    int cloneFromTo(int fromRow, int fromCol, int toRow, int toCol);
-    int moveFromTo(int fromRow, int fromCol, int toRow, int toCol);
-    void capture(Cell& cell);
+    Position getPosition() const;
 };
+
@@ -4,8 +4,9 @@
 #include "Game.h"
 #include "pallete.h"
 #include "Serialization.h"
+#include "Tween.h"
 
-Game::Game(sf::RenderWindow& window, bool singleGame, sf::Font& font) : window(window), score(font) {
+Game::Game(sf::RenderWindow& window, bool singleGame, sf::Font& font, AiKind aiKind) : window(window), score(font) {
     this->font = font;
 
     std::vector<sf::Color> colors = {
@@ -20,9 +21,10 @@ Game::Game(sf::RenderWindow& window, bool singleGame, sf::Font& font) : window(w
     };
     escMenu = std::make_unique<Menu>(font, window, colors, labels, "Hexagon", Palette::Yellow);
 
-    board = std::make_unique<Board>(window, singleGame);
+    board = std::make_unique<Board>(window, singleGame, aiKind);
 
     this->singleGame = singleGame;
+    this->aiKind = aiKind;
 }
 
 void Game::processEvents() {
@@ -33,6 +35,9 @@ void Game::processEvents() {
             if (keyPressed->scancode == sf::Keyboard::Scan::Escape && !board->isGameOver) {
                 window.clear(Palette::Background);
                 escMenuActive = !escMenuActive;
+                if (escMenuActive) {
+                    board->cancelAi();
+                }
             }
         }
 
@@ -65,9 +70,9 @@ void Game::run(bool _loadGame) {
         dt = clock.restart().asSeconds();
 
         processEvents();
+        tweens().advance(dt);
 
         if (escMenuActive) {
-            escMenu->update(dt);
             escMenu->draw();
 
             if (escMenu->getSelected() != -1) {
@@ -83,6 +88,7 @@ void Game::run(bool _loadGame) {
                         loadGame();
                         break;
                     case 2:
+                        board->cancelAi();
                         return;
                         break;
                 }
@@ -95,13 +101,10 @@ void Game::run(bool _loadGame) {
                 score.change();
                 oldIsPlayer1Turn = board->isPlayer1Turn;
             }
-            score.update(dt);
             score.draw(window);
 
-            score.setScore(
-                board->getCellsWithState(CellState::Player1).size(),
-                board->getCellsWithState(CellState::Player2).size()
-            );
+            Position position = board->getPosition();
+            score.setScore(position.count(CellState::Player1), position.count(CellState::Player2));
         } else if (showResultsDelay > 1.5) {
             if (resultMenu == nullptr) {
                 initResulltMenu(font, board->isPlayer1Win);
@@ -113,9 +116,9 @@ void Game::run(bool _loadGame) {
                 resultMenu->resetSelected();
                 switch (selected) {
                     case 0:
-                        score = Score(font);
+                        score.reset();
                         window.clear(Palette::Background);
-                        board = std::make_unique<Board>(window, singleGame);
+                        board = std::make_unique<Board>(window, singleGame, aiKind);
                         isPlayer1Turn = true;
                         oldIsPlayer1Turn = true;
                         resultMenu = nullptr;
@@ -145,7 +148,6 @@ void Game::run(bool _loadGame) {
 }
 
 void Game::showResults() {
-    resultMenu->update(dt);
     resultMenu->draw();
 }
 
@@ -172,17 +174,18 @@ void Game::initResulltMenu(sf::Font& font, bool isPlayer1Win) {
 
 void Game::loadGame() {
     std::cout << "Load game" << std::endl;
-    score = Score(font);
+    board->cancelAi();
+    score.reset();
     window.clear(Palette::Background);
     board = std::make_unique<Board>(load(window));
+    singleGame = board->singleGame;
+    aiKind = board->aiKind;
     isPlayer1Turn = board->isPlayer1Turn;
     oldIsPlayer1Turn = isPlayer1Turn;
     resultMenu = nullptr;
     escMenuActive = false;
-    score.setScore(
-        board->getCellsWithState(CellState::Player1).size(),
-        board->getCellsWithState(CellState::Player2).size()
-    );
+    Position position = board->getPosition();
+    score.setScore(position.count(CellState::Player1), position.count(CellState::Player2));
     if (!board->isPlayer1Turn) {
         score.change();
     }
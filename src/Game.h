@@ -3,6 +3,8 @@
 #include <SFML/Graphics.hpp>
 #include "Menu.h"
 #include "Board.h"
+#include "Hexagon.h"
+#include "Tween.h"
 #include "pallete.h"
 
 class Score {
@@ -13,10 +15,27 @@ public:
 
         redScore.setFillColor(Palette::p2Color);
         greenScore.setFillColor(Palette::p1Color);
-
-        greenHex.setFillColor(greenSelectedColor);
     };
 
+    // tweens() writes into the fills, so a score is never assigned over; reset() it instead
+    Score(const Score&) = default;
+    Score& operator=(const Score&) = delete;
+
+    ~Score() {
+        tweens().cancel(this, sizeof(Score));
+    }
+
+    // Back to the look of a new game: Player1 to move, three pieces each.
+    void reset() {
+        tweens().cancel(this, sizeof(Score));
+        isGreenSelected = true;
+        greenFill = greenSelectedColor;
+        redFill = Palette::Background;
+        greenScore.setString("3");
+        redScore.setString("3");
+        centerText();
+    }
+
     void setScore(int score_1, int score_2) {
         if (score_1 != score_green) {
             greenScore.setString(std::to_string(score_1));
@@ -28,6 +47,8 @@ public:
     };
     
     void draw(sf::RenderWindow& window) {
+        redHex.setFillColor(redFill);
+        greenHex.setFillColor(greenFill);
         window.draw(redHex);
         window.draw(greenHex);
         window.draw(redScore);
@@ -36,45 +57,23 @@ public:
 
     void change() {
         isGreenSelected = !isGreenSelected;
-        animationTime = 0.0f;
-    }
-
-    void update(float dt) {
-        animationTime += dt;
-        float t = animationTime / 0.2f;
-        if (t > 1.0f) {
-            t = 1.0f;
-        }
-
-        sf::Color greenOld = isGreenSelected ? Palette::Background : redSelectedColor;
-        sf::Color redOld = isGreenSelected ? redSelectedColor : Palette::Background;
-
-        sf::Color greenTarget = isGreenSelected ? greenSelectedColor : Palette::Background;
-        sf::Color redTarget = isGreenSelected ? Palette::Background : redSelectedColor;
-    
-        greenHex.setFillColor(sf::Color(
-            (int)((1 - t) * greenOld.r + t * greenTarget.r),
-            (int)((1 - t) * greenOld.g + t * greenTarget.g),
-            (int)((1 - t) * greenOld.b + t * greenTarget.b)
-        ));
-        redHex.setFillColor(sf::Color(
-            (int)((1 - t) * redOld.r + t * redTarget.r),
-            (int)((1 - t) * redOld.g + t * redTarget.g),
-            (int)((1 - t) * redOld.b + t * redTarget.b)
-        ));
+        tweens().colors.start(&greenFill, isGreenSelected ? greenSelectedColor : Palette::Background, 0.2f);
+        tweens().colors.start(&redFill, isGreenSelected ? Palette::Background : redSelectedColor, 0.2f);
     }
 
 private:
     int score_green = 3;
     int score_red = 3;
 
-    float animationTime = 1.0f;
-
     bool isGreenSelected = true;
 
     sf::Color greenSelectedColor = sf::Color(70, 87, 79);
     sf::Color redSelectedColor = sf::Color(113, 50, 60);
 
+    // the hexes' fill, faded by tweens() when the turn changes
+    sf::Color greenFill = greenSelectedColor;
+    sf::Color redFill = Palette::Background;
+
     sf::ConvexShape redHex;
     sf::ConvexShape greenHex;
 
@@ -87,14 +86,8 @@ private:
     int greenHexY = 360;
 
     void initShapes() {
-        redHex.setPointCount(6);
-        greenHex.setPointCount(6);
-
-        for (int i = 0; i < 6; ++i) {
-            float angle = i * 2 * 3.14159f / 6;
-            redHex.setPoint(i,   {redHexX   + 80 * static_cast<float>(cos(angle)), redHexY + 80 * static_cast<float>(sin(angle))});
-            greenHex.setPoint(i, {greenHexX   + 80 * static_cast<float>(cos(angle)), greenHexY + 80 * static_cast<float>(sin(angle))});
-        }
+        redHex = hexagonShape(sf::Vector2f(redHexX, redHexY), 80);
+        greenHex = hexagonShape(sf::Vector2f(greenHexX, greenHexY), 80);
 
         redHex.setOutlineThickness(3);
         greenHex.setOutlineThickness(3);
@@ -133,6 +126,7 @@ private:
     std::unique_ptr<Menu> resultMenu = nullptr;
 
     bool singleGame = false;
+    AiKind aiKind = AiKind::Minimax;
 
 
     void showResults();
@@ -142,7 +136,7 @@ private:
 public:
     std::unique_ptr<Board> board;
     
-    Game(sf::RenderWindow& window, bool singleGame, sf::Font& font);
+    Game(sf::RenderWindow& window, bool singleGame, sf::Font& font, AiKind aiKind = AiKind::Minimax);
 
     void run(bool _loadGame);
     
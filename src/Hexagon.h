@@ -0,0 +1,22 @@
+#pragma once
+
+#include <SFML/Graphics.hpp>
+
+// Corners of the flat-topped hexagon of radius 1 that cells, buttons and the score are drawn
+// with, clockwise from the rightmost one. Shapes scale and move it instead of redoing the trig.
+namespace UnitHexagon {
+    constexpr float halfRoot3 = 0.866025404f;
+
+    inline constexpr sf::Vector2f corners[6] = {
+        {1.0f, 0.0f}, {0.5f, halfRoot3}, {-0.5f, halfRoot3},
+        {-1.0f, 0.0f}, {-0.5f, -halfRoot3}, {0.5f, -halfRoot3},
+    };
+}
+
+inline sf::ConvexShape hexagonShape(sf::Vector2f center, float radius) {
+    sf::ConvexShape shape(6);
+    for (int i = 0; i < 6; ++i) {
+        shape.setPoint(i, center + UnitHexagon::corners[i] * radius);
+    }
+    return shape;
+}
@@ -1,4 +1,6 @@
 #include "Menu.h"
+#include "Hexagon.h"
+#include "Tween.h"
 #include <iostream>
 
 namespace 
@@ -12,14 +14,8 @@ namespace
 
 
 HexButton::HexButton(float x, float y, float size, int font_size, const std::string& label, const sf::Font& font, sf::Color outlineColor)
-    : text(font, label, font_size) 
+    : shape(hexagonShape({x, y}, size)), text(font, label, font_size) 
 {
-    shape.setPointCount(6);
-    for (int i = 0; i < 6; ++i) {
-        float angle = i * 2 * 3.14159f / 6;
-        shape.setPoint(i, {x + size * static_cast<float>(cos(angle)), y + size * static_cast<float>(sin(angle))});
-    }
-    
     shape.setFillColor(normalColor);
     shape.setOutlineThickness(3);
     shape.setOutlineColor(outlineColor);
@@ -28,35 +24,22 @@ HexButton::HexButton(float x, float y, float size, int font_size, const std::str
     text.setPosition({x - text.getGlobalBounds().size.x / 2, y - text.getGlobalBounds().size.y / 2 - 5});
 }
 
+HexButton::~HexButton() {
+    tweens().cancel(this, sizeof(HexButton));
+}
+
 void HexButton::draw(sf::RenderWindow& window) {
+    shape.setFillColor(currentColor);
     window.draw(shape);
     window.draw(text);
 }
 
 void HexButton::ifHovered(const sf::Vector2f& mousePos)  {
-    hovered = shape.getGlobalBounds().contains(mousePos);
-    if (hovered != oldHoveredState) {
-        oldColor = currentColor;
-        animationTime = 0.0f;
-        targetColor = hovered ? hoverColor : normalColor;
-        oldHoveredState = hovered;
-    }
-}
-
-void HexButton::updateColor(float dt) {
-    animationTime += dt;
-    float t = animationTime / animation_duration;
-
-    // std::cout << t << std::endl;
-    if (t > 1.0f) {
-        t = 1.0f;
+    bool now = shape.getGlobalBounds().contains(mousePos);
+    if (now != hovered) {
+        hovered = now;
+        tweens().colors.start(&currentColor, hovered ? hoverColor : normalColor, animation_duration);
     }
-
-    currentColor.r = (int)((1 - t) * oldColor.r + t * targetColor.r);
-    currentColor.g = (int)((1 - t) * oldColor.g + t * targetColor.g);
-    currentColor.b = (int)((1 - t) * oldColor.b + t * targetColor.b);
-
-    shape.setFillColor(currentColor);
 }
 
 bool HexButton::isHovered(const sf::Vector2f& mousePos) {
@@ -121,12 +104,6 @@ void Menu::handleEvent(const sf::Event& event) {
     }
 }
 
-void Menu::update(float dt) {
-    for (auto& button : buttons) {
-        button.updateColor(dt); // Примерный dt, можно заменить на реальный
-    }
-}
-
 int Menu::getSelected() {
     return selected;
 }
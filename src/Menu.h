@@ -11,22 +11,20 @@ struct HexButton {
     sf::Color color;
     sf::Color hoverColor = Palette::Surface1;
     sf::Color normalColor = Palette::Surface0;
+    // faded by tweens()
     sf::Color currentColor = normalColor;
-    sf::Color oldColor = normalColor;
-    sf::Color targetColor = normalColor;
 
     bool hovered = false;
-    bool oldHoveredState = false;    
-    float animationTime = 0.0f;
 
     HexButton(float x, float y, float size, int font_size, 
               const std::string& label, const sf::Font& font, sf::Color outlineColor);
+    HexButton(const HexButton&) = default;
+    HexButton& operator=(const HexButton&) = delete;
+    ~HexButton();
     
     void draw(sf::RenderWindow& window);
 
     void ifHovered(const sf::Vector2f& mousePos);
-
-    void updateColor(float dt);
     
     bool isHovered(const sf::Vector2f& mousePos);
 };
@@ -43,8 +41,6 @@ public:
     // Отрисовка меню
     void draw();
 
-    void update(float dt);
-
     int getSelected();
     void resetSelected();
 
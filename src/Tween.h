@@ -0,0 +1,133 @@
+#pragma once
+
+#include <SFML/Graphics.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+inline float lerp(float from, float to, float t) {
+    return from + (to - from) * t;
+}
+
+inline sf::Color lerp(sf::Color from, sf::Color to, float t) {
+    return sf::Color(
+        static_cast<std::uint8_t>((1 - t) * from.r + t * to.r),
+        static_cast<std::uint8_t>((1 - t) * from.g + t * to.g),
+        static_cast<std::uint8_t>((1 - t) * from.b + t * to.b),
+        static_cast<std::uint8_t>((1 - t) * from.a + t * to.a)
+    );
+}
+
+// Running linear tweens of one value type, one array per field. Each tween writes straight
+// into the value it animates and raises the owner's changed flag, if any, when it does.
+// Finished tweens are swapped out, so advancing costs nothing once everything has settled.
+template <typename T>
+class TweenSet {
+public:
+    // A running tween of the same value is replaced and the new one starts from its current state.
+    void start(T* value, T to, float duration, bool* changed = nullptr) {
+        size_t i = find(value);
+        if (i == values.size()) {
+            values.push_back(value);
+            from.push_back(*value);
+            targets.push_back(to);
+            elapsed.push_back(0.0f);
+            durations.push_back(duration);
+            changedFlags.push_back(changed);
+        } else {
+            from[i] = *value;
+            targets[i] = to;
+            elapsed[i] = 0.0f;
+            durations[i] = duration;
+            changedFlags[i] = changed;
+        }
+    }
+
+    void advance(float dt) {
+        for (size_t i = 0; i < values.size();) {
+            elapsed[i] += dt;
+            float t = elapsed[i] < durations[i] ? elapsed[i] / durations[i] : 1.0f;
+            *values[i] = lerp(from[i], targets[i], t);
+            if (changedFlags[i] != nullptr) *changedFlags[i] = true;
+
+            if (t < 1.0f) {
+                i++;
+            } else {
+                retire(i);
+            }
+        }
+    }
+
+    // Drops, without finishing them, the tweens of values inside [owner, owner + size).
+    void cancel(const void* owner, size_t size) {
+        auto begin = static_cast<const char*>(owner);
+        for (size_t i = 0; i < values.size();) {
+            auto address = reinterpret_cast<const char*>(values[i]);
+            if (address >= begin && address < begin + size) {
+                retire(i);
+            } else {
+                i++;
+            }
+        }
+    }
+
+    bool isRunning(const T* value) const { return find(value) != values.size(); }
+    size_t size() const { return values.size(); }
+
+private:
+    std::vector<T*> values;
+    std::vector<T> from;
+    std::vector<T> targets;
+    std::vector<float> elapsed;
+    std::vector<float> durations;
+    std::vector<bool*> changedFlags;
+
+    size_t find(const T* value) const {
+        size_t i = 0;
+        while (i < values.size() && values[i] != value) i++;
+        return i;
+    }
+
+    void retire(size_t i) {
+        size_t last = values.size() - 1;
+        values[i] = values[last];
+        from[i] = from[last];
+        targets[i] = targets[last];
+        elapsed[i] = elapsed[last];
+        durations[i] = durations[last];
+        changedFlags[i] = changedFlags[last];
+
+        values.pop_back();
+        from.pop_back();
+        targets.pop_back();
+        elapsed.pop_back();
+        durations.pop_back();
+        changedFlags.pop_back();
+    }
+};
+
+// Every animation of the interface: board cells, menu buttons and the score. The frame loop
+// advances it once per frame; objects that own animated values cancel them when destroyed.
+struct TweenScheduler {
+    TweenSet<sf::Color> colors;
+    TweenSet<float> scalars;
+
+    void advance(float dt) {
+        colors.advance(dt);
+        scalars.advance(dt);
+    }
+
+    void cancel(const void* owner, size_t size) {
+        colors.cancel(owner, size);
+        scalars.cancel(owner, size);
+    }
+
+    bool idle() const { return colors.size() == 0 && scalars.size() == 0; }
+};
+
+// The one scheduler of the process; the interface runs on a single thread.
+inline TweenScheduler& tweens() {
+    static TweenScheduler scheduler;
+    return scheduler;
+}
@@ -0,0 +1,93 @@
+#include "AsyncSearch.h"
+
+AsyncSearch::AsyncSearch(int threads, int hashSizeMb, AiKind kind) {
+    if (kind == AiKind::Mcts) {
+        mcts = std::make_unique<MctsEngine>(threads);
+    } else {
+        engine = std::make_unique<Engine>(hashSizeMb, threads);
+    }
+}
+
+AsyncSearch::~AsyncSearch() {
+    cancel();
+}
+
+void AsyncSearch::setOpeningBook(std::shared_ptr<const OpeningBook> book) {
+    cancel();
+    if (engine) engine->setOpeningBook(std::move(book));
+    else mcts->setOpeningBook(std::move(book));
+}
+
+void AsyncSearch::setEvalWeights(const EvalWeights& weights) {
+    cancel();
+    if (engine) engine->setEvalWeights(weights);
+}
+
+void AsyncSearch::setNetwork(std::shared_ptr<const NnueNetwork> network) {
+    cancel();
+    if (engine) engine->setNetwork(std::move(network));
+}
+
+void AsyncSearch::start(const Position& position, CellState player, const SearchLimits& limits) {
+    cancel();
+
+    cancelled = false;
+    finished = false;
+    running = true;
+    pondering = false;
+    searchedKey = position.key ^ Zobrist::sideKey(Position::side(player));
+
+    SearchLimits threadLimits = limits;
+    threadLimits.stopSignal = &cancelled;
+
+    worker = std::thread([this, position, player, threadLimits] {
+        result = run(position, player, threadLimits);
+        finished.store(true, std::memory_order_release);
+    });
+}
+
+void AsyncSearch::ponder(const Position& position, CellState player) {
+    start(position, player, {});
+    pondering = true;
+}
+
+void AsyncSearch::cancel() {
+    cancelled = true;
+    if (worker.joinable()) {
+        worker.join();
+    }
+    running = false;
+}
+
+std::optional<SearchResult> AsyncSearch::poll() {
+    if (!running || !finished.load(std::memory_order_acquire)) {
+        return std::nullopt;
+    }
+
+    worker.join();
+    running = false;
+    if (pondering) {
+        return std::nullopt;
+    }
+    return result;
+}
+
+SearchResult AsyncSearch::run(const Position& position, CellState player, const SearchLimits& limits) {
+    if (engine) {
+        return engine->search(position, player, limits);
+    }
+
+    MctsResult found = mcts->search(position, player, {0, limits.timeMs, limits.stopSignal});
+
+    // reported like an alpha-beta result: depth is the length of the most visited line,
+    // score the win rate in evaluation units
+    SearchResult converted;
+    converted.bestMove = found.bestMove;
+    converted.score = scoreForExpectedResult(found.winRate);
+    converted.depth = static_cast<int>(found.pv.size());
+    converted.pv = found.pv;
+    converted.nodes = found.iterations;
+    converted.timeMs = found.timeMs;
+    converted.fromBook = found.fromBook;
+    return converted;
+}
@@ -0,0 +1,60 @@
+#pragma once
+
+#include <atomic>
+#include <optional>
+#include <thread>
+
+#include "Mcts.h"
+#include "ai.h"
+
+enum class AiKind { Minimax, Mcts };
+
+// Runs the alpha-beta Engine or the MctsEngine on a background thread so the caller's frame
+// loop never blocks. The position is copied when the search starts; the result is collected with poll().
+class AsyncSearch {
+public:
+    explicit AsyncSearch(int threads = 1, int hashSizeMb = TranspositionTable::defaultSizeMb,
+                         AiKind kind = AiKind::Minimax);
+    ~AsyncSearch();
+
+    AsyncSearch(const AsyncSearch&) = delete;
+    AsyncSearch& operator=(const AsyncSearch&) = delete;
+
+    // Both engine kinds answer book positions without searching.
+    void setOpeningBook(std::shared_ptr<const OpeningBook> book);
+    // Only the alpha-beta engine has a static evaluation; MCTS plays its games out.
+    void setEvalWeights(const EvalWeights& weights);
+    void setNetwork(std::shared_ptr<const NnueNetwork> network);
+
+    // Cancels any search in flight first.
+    void start(const Position& position, CellState player, const SearchLimits& limits);
+    // Searches the opponent's position without limits until cancelled. It yields no move, but the
+    // transposition table or search tree it fills carries over to the next start().
+    void ponder(const Position& position, CellState player);
+    // Stops the search and drops its result; returns once the search thread has finished.
+    void cancel();
+
+    // True from start() until the result has been collected or cancelled.
+    bool isSearching() const { return running; }
+    bool isPondering() const { return running && pondering; }
+    // The finished search's result, handed out once.
+    std::optional<SearchResult> poll();
+
+    // Zobrist key (side to move included) of the position being searched.
+    uint64_t getSearchedKey() const { return searchedKey; }
+
+private:
+    SearchResult run(const Position& position, CellState player, const SearchLimits& limits);
+
+    // only the engine of the chosen kind is created
+    std::unique_ptr<Engine> engine;
+    std::unique_ptr<MctsEngine> mcts;
+    std::thread worker;
+    std::atomic<bool> cancelled = false;
+    std::atomic<bool> finished = false;
+    bool running = false;
+    bool pondering = false;
+
+    SearchResult result;
+    uint64_t searchedKey = 0;
+};
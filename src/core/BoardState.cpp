@@ -0,0 +1,38 @@
+#include "BoardState.h"
+
+namespace {
+    std::vector<std::pair<int, int>> toCells(Bitboard bb) {
+        std::vector<std::pair<int, int>> cells;
+        cells.reserve(popcount(bb));
+
+        while (bb) {
+            int cell = popLsb(bb);
+            cells.push_back(std::make_pair(cellRow(cell), cellCol(cell)));
+        }
+        return cells;
+    }
+}
+
+std::vector<std::pair<int, int>> BoardState::getCellsWithState(CellState state) const {
+    return toCells(position.cellsWithState(state));
+}
+
+std::vector<std::pair<int, int>> BoardState::getAvailableForCloningCells(int fromRow, int fromCol) const {
+    return toCells(position.cloneTargets(cellIndex(fromRow, fromCol)));
+}
+
+std::vector<std::pair<int, int>> BoardState::getAvailableForMovingCells(int fromRow, int fromCol) const {
+    return toCells(position.jumpTargets(cellIndex(fromRow, fromCol)));
+}
+
+int BoardState::cloneFromTo(int fromRow, int fromCol, int toRow, int toCol) {
+    return position.clone(cellIndex(fromRow, fromCol), cellIndex(toRow, toCol));
+}
+
+int BoardState::moveFromTo(int fromRow, int fromCol, int toRow, int toCol) {
+    return position.jump(cellIndex(fromRow, fromCol), cellIndex(toRow, toCol));
+}
+
+int BoardState::capture(int row, int col) {
+    return position.capture(cellIndex(row, col));
+}
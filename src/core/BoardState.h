@@ -0,0 +1,20 @@
+#pragma once
+
+#include <utility>
+#include <vector>
+
+#include "Position.h"
+
+class BoardState {
+public:
+    explicit BoardState(const Position& position) : position(position) {};
+
+    Position position;
+
+    std::vector<std::pair<int, int>> getCellsWithState(CellState state) const;
+    std::vector<std::pair<int, int>> getAvailableForCloningCells(int fromRow, int fromCol) const;
+    std::vector<std::pair<int, int>> getAvailableForMovingCells(int fromRow, int fromCol) const;
+    int cloneFromTo(int fromRow, int fromCol, int toRow, int toCol);
+    int moveFromTo(int fromRow, int fromCol, int toRow, int toCol);
+    int capture(int row, int col);
+};
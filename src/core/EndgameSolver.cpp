@@ -0,0 +1,269 @@
+#include "EndgameSolver.h"
+
+#include <algorithm>
+
+namespace {
+    constexpr int maxMargin = BoardGeometry::cellCount;
+
+    // ordering weights: captures first, then clones, then contested regions, odd-sized ones first
+    constexpr int captureWeight = 1 << 12;
+    constexpr int cloneWeight = 1 << 10;
+    constexpr int contestedWeight = 1 << 9;
+    constexpr int parityWeight = 1 << 8;
+
+    uint64_t quietKey(int quietPlies) {
+        return quietPlies * 0x9E3779B97F4A7C15ull;
+    }
+
+    void pickMove(MoveList& moves, int* order, int index) {
+        int best = index;
+        for (int i = index + 1; i < moves.size; i++) {
+            if (order[i] > order[best]) best = i;
+        }
+        std::swap(moves.moves[index], moves.moves[best]);
+        std::swap(order[index], order[best]);
+    }
+}
+
+SolveResult EndgameSolver::solve(const Position& root, int side, SolveMode mode, const SolveLimits& limits) {
+    this->limits = limits;
+    startTime = std::chrono::steady_clock::now();
+    position = root;
+    nodes = 0;
+    aborted = false;
+    adjudicated = false;
+    tt.newSearch();
+
+    pathKeys[0] = position.key ^ Zobrist::sideKey(side);
+    lastClone[0] = 0;
+
+    SolveResult result;
+    if (position.isGameOver(side)) {
+        int margin = position.finalMargin(side);
+        result.margin = side == 0 ? margin : -margin;
+        result.complete = true;
+        return result;
+    }
+
+    int alpha = mode == SolveMode::Exact ? -maxMargin - 1 : -1;
+    int beta = mode == SolveMode::Exact ? maxMargin + 1 : 1;
+
+    MoveList moves;
+    position.generateMoves(side, moves);
+    EmptyRegion regions[BoardGeometry::cellCount];
+    int regionCount = position.emptyRegions(regions);
+    int order[maxMoves];
+    orderMoves(moves, side, regions, regionCount, order);
+
+    // the hash move of an earlier, interrupted solve goes first
+    TTEntry entry;
+    if (tt.probe(pathKeys[0], entry) && entry.move.isValid()) {
+        auto found = std::find(moves.begin(), moves.end(), entry.move);
+        if (found != moves.end()) {
+            order[found - moves.begin()] = 1 << 30;
+        }
+    }
+
+    int bestScore = -maxMargin - 1;
+    for (int i = 0; i < moves.size; i++) {
+        pickMove(moves, order, i);
+        const Move& move = moves.moves[i];
+
+        position.makeMove(side, move, undoStack[0]);
+        pathKeys[1] = position.key ^ Zobrist::sideKey(side ^ 1);
+        lastClone[1] = move.type == MoveType::Clone ? 1 : lastClone[0];
+        int score = -search(side ^ 1, 1, -beta, -alpha);
+        position.unmakeMove(side, undoStack[0]);
+
+        if (aborted) break;
+        if (score > bestScore) {
+            bestScore = score;
+            result.bestMove = move;
+            alpha = std::max(alpha, score);
+        }
+        if (alpha >= beta) break;
+    }
+
+    result.margin = bestScore;
+    result.complete = !aborted;
+    result.adjudicated = adjudicated;
+    result.nodes = nodes;
+    result.timeMs = static_cast<int>(std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::steady_clock::now() - startTime).count());
+
+    if (result.complete) {
+        tt.store(pathKeys[0], {result.bestMove, bestScore, adjudicated ? 1 : 0, Bound::Exact});
+    }
+    return result;
+}
+
+int EndgameSolver::search(int side, int ply, int alpha, int beta) {
+    nodes++;
+
+    if (position.isGameOver(side)) {
+        int margin = position.finalMargin(side);
+        return side == 0 ? margin : -margin;
+    }
+    if (ply - lastClone[ply] >= quietPlyLimit || isRepetition(ply)) {
+        adjudicated = true;
+        if (limits.proofOnly) {
+            aborted = true;
+            return 0;
+        }
+        return popcount(position.pieces[side]) - popcount(position.pieces[side ^ 1]);
+    }
+    EmptyRegion regions[BoardGeometry::cellCount];
+    int regionCount = position.emptyRegions(regions);
+    int settled;
+    if (scoreSettledRegions && settledMargin(side, regions, regionCount, settled)) {
+        return settled;
+    }
+
+    if (ply >= maxSolvePly || timeIsUp()) {
+        aborted = true;
+        return 0;
+    }
+
+    // the quiet-ply count changes what a position is worth, so it is part of the hash key
+    uint64_t key = pathKeys[ply] ^ quietKey(ply - lastClone[ply]);
+    int alphaOrig = alpha;
+    Move hashMove;
+    TTEntry entry;
+    if (tt.probe(key, entry)) {
+        hashMove = entry.move;
+        if (entry.bound == Bound::Exact
+            || (entry.bound == Bound::Lower && entry.score >= beta)
+            || (entry.bound == Bound::Upper && entry.score <= alpha)) {
+            adjudicated |= entry.depth != 0;
+            if (adjudicated && limits.proofOnly) {
+                aborted = true;
+                return 0;
+            }
+            return entry.score;
+        }
+        if (entry.bound == Bound::Lower) alpha = std::max(alpha, entry.score);
+        if (entry.bound == Bound::Upper) beta = std::min(beta, entry.score);
+    }
+
+    MoveList moves;
+    position.generateMoves(side, moves);
+
+    int order[maxMoves];
+    orderMoves(moves, side, regions, regionCount, order);
+    if (hashMove.isValid()) {
+        auto found = std::find(moves.begin(), moves.end(), hashMove);
+        if (found != moves.end()) {
+            order[found - moves.begin()] = 1 << 30;
+        }
+    }
+
+    // the flag of this subtree alone, so its hash entry carries the right one; bounds taken
+    // from an adjudicated entry count too
+    bool adjudicatedBefore = adjudicated;
+    adjudicated = entry.depth != 0;
+    int bestScore = -maxMargin - 1;
+    Move bestMove;
+
+    for (int i = 0; i < moves.size; i++) {
+        pickMove(moves, order, i);
+        const Move& move = moves.moves[i];
+
+        position.makeMove(side, move, undoStack[ply]);
+        pathKeys[ply + 1] = position.key ^ Zobrist::sideKey(side ^ 1);
+        lastClone[ply + 1] = move.type == MoveType::Clone ? ply + 1 : lastClone[ply];
+        int score = -search(side ^ 1, ply + 1, -beta, -alpha);
+        position.unmakeMove(side, undoStack[ply]);
+
+        if (aborted) return 0;
+
+        if (score > bestScore) {
+            bestScore = score;
+            bestMove = move;
+            if (score > alpha) {
+                alpha = score;
+                if (alpha >= beta) break;
+            }
+        }
+    }
+
+    Bound bound = bestScore >= beta ? Bound::Lower : bestScore > alphaOrig ? Bound::Exact : Bound::Upper;
+    tt.store(key, {bestMove, bestScore, adjudicated ? 1 : 0, bound});
+    adjudicated |= adjudicatedBefore;
+    return bestScore;
+}
+
+// With every region reachable by one side only, each side clones its own regions full and
+// whoever gets stuck first only hands over cells the other side would fill anyway, so the
+// regions add up independently of move order. That holds only while neither side can reach
+// into the other's part of the board, and two things can open a way in. Regions of
+// different sides may sit within jumping distance across blocked cells, so the first piece
+// put there reaches the other region. And a piece that jumps into its side's region leaves
+// a hole behind, which the opponent may move into and capture from. So every region, and
+// every piece that can jump into one, must stay out of the other side's reach, its future
+// pieces included. A region neither side reaches goes to whoever keeps the tempo, and
+// jumps can waste tempo; all of these cases are searched.
+bool EndgameSolver::settledMargin(int side, const EmptyRegion* regions, int regionCount, int& margin) const {
+    Bitboard owned[2] = {0, 0};
+    for (int i = 0; i < regionCount; i++) {
+        const EmptyRegion& region = regions[i];
+        if (region.reachable[side] == region.reachable[side ^ 1]) return false;
+        owned[region.reachable[side] ? side : side ^ 1] |= region.cells;
+    }
+
+    // cells within moving distance of cells
+    auto reach = [](Bitboard cells) { return neighbors(neighbors(cells) | cells) | cells; };
+    for (int owner = 0; owner < 2; owner++) {
+        Bitboard opponentReach = reach(position.pieces[owner ^ 1] | owned[owner ^ 1]);
+        Bitboard movers = reach(owned[owner]) & position.pieces[owner];
+        if ((owned[owner] | movers) & opponentReach) return false;
+    }
+
+    margin = popcount(position.pieces[side]) + popcount(owned[side])
+        - popcount(position.pieces[side ^ 1]) - popcount(owned[side ^ 1]);
+    return true;
+}
+
+// Captures and clones first. Regions only the mover reaches cannot be taken away, so moves
+// into contested regions come before them, odd-sized ones first (the side that fills a
+// region last keeps it).
+void EndgameSolver::orderMoves(MoveList& moves, int side, const EmptyRegion* regions, int regionCount,
+                               int* order) const {
+    Bitboard contested = 0;
+    Bitboard oddContested = 0;
+    for (int i = 0; i < regionCount; i++) {
+        if (!regions[i].contested()) continue;
+        contested |= regions[i].cells;
+        if (popcount(regions[i].cells) & 1) oddContested |= regions[i].cells;
+    }
+
+    NeighborCounts captures = neighborCounts(position.pieces[side ^ 1]);
+    for (int i = 0; i < moves.size; i++) {
+        const Move& move = moves.moves[i];
+        Bitboard target = cellBit(move.to);
+
+        order[i] = captures.at(move.to) * captureWeight
+            + (move.type == MoveType::Clone ? cloneWeight : 0)
+            + ((contested & target) ? contestedWeight : 0)
+            + ((oddContested & target) ? parityWeight : 0);
+    }
+}
+
+// Nothing repeats across a clone, since it adds a piece to the board.
+bool EndgameSolver::isRepetition(int ply) const {
+    for (int earlier = ply - 2; earlier >= lastClone[ply]; earlier -= 2) {
+        if (pathKeys[earlier] == pathKeys[ply]) return true;
+    }
+    return false;
+}
+
+bool EndgameSolver::timeIsUp() {
+    if ((nodes & 1023) != 0) return false;
+    if (limits.stopSignal && limits.stopSignal->load(std::memory_order_relaxed)) {
+        return true;
+    }
+    if (limits.timeMs > 0) {
+        auto elapsed = std::chrono::steady_clock::now() - startTime;
+        return elapsed >= std::chrono::milliseconds(limits.timeMs);
+    }
+    return false;
+}
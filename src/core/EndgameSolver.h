@@ -0,0 +1,78 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+
+#include "Position.h"
+#include "TranspositionTable.h"
+
+enum class SolveMode { WinLossDraw, Exact };
+
+struct SolveLimits {
+    int timeMs = 0;  // 0 - no time limit
+    // raised by another thread to abort the solve
+    const std::atomic<bool>* stopSignal = nullptr;
+    // give up at the first adjudicated line, for callers that want a proof or nothing
+    bool proofOnly = false;
+};
+
+struct SolveResult {
+    Move bestMove;
+    // Final Player-to-move minus opponent pieces under perfect play; in WinLossDraw mode
+    // only the sign is meaningful.
+    int margin = 0;
+    // false when the solve ran out of time or plies and margin is not proven
+    bool complete = false;
+    // some line was scored on its pieces at the quiet-ply limit or a repetition, so margin
+    // holds under that convention only, not under the rules of the game
+    bool adjudicated = false;
+    uint64_t nodes = 0;
+    int timeMs = 0;
+};
+
+// Perfect-play search to the end of the game for positions with few empty cells.
+// Ends come from Position::isGameOver/finalMargin, the same rules the game uses.
+// Jumps do not fill the board, so the game itself has no bound on its length. A line that
+// repeats a position or goes quietPlyLimit plies without a clone is adjudicated on the
+// pieces it has at that point; results are exact under that convention and say so in
+// SolveResult::adjudicated.
+// Once the empty cells split into regions that only one side can reach each, the regions
+// are scored independently instead of searched (see settledMargin).
+class EndgameSolver {
+public:
+    static constexpr int defaultEmptyThreshold = 8;
+    static constexpr int maxSolvePly = 96;
+
+    // Every extra ply multiplies the jump lines searched; 2 answers a jump with a clone or
+    // ends the line, and solves 8 empty cells in well under a second on one core.
+    int quietPlyLimit = 2;
+    // score settled regions without searching them; off only to check that shortcut
+    bool scoreSettledRegions = true;
+
+    explicit EndgameSolver(int hashSizeMb = 8) : tt(hashSizeMb) {}
+
+    SolveResult solve(const Position& position, int side, SolveMode mode, const SolveLimits& limits = {});
+    void clearHash() { tt.clear(); }
+
+private:
+    int search(int side, int ply, int alpha, int beta);
+    bool settledMargin(int side, const EmptyRegion* regions, int regionCount, int& margin) const;
+    void orderMoves(MoveList& moves, int side, const EmptyRegion* regions, int regionCount, int* order) const;
+    bool isRepetition(int ply) const;
+    bool timeIsUp();
+
+    Position position;
+    Undo undoStack[maxSolvePly];
+    // position keys along the current line, and the last ply that cloned (nothing repeats across a clone)
+    uint64_t pathKeys[maxSolvePly + 1];
+    int lastClone[maxSolvePly + 1];
+
+    TranspositionTable tt;
+    SolveLimits limits;
+    std::chrono::steady_clock::time_point startTime;
+    uint64_t nodes = 0;
+    bool aborted = false;
+    // whether the subtree being searched adjudicated a line; hash entries keep it in their depth
+    bool adjudicated = false;
+};
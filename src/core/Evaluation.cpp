@@ -0,0 +1,104 @@
+#include "Evaluation.h"
+
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+#include <sstream>
+#include <stdexcept>
+#include <string_view>
+
+namespace {
+    constexpr const char* termNames[evalTermCount] = {
+        "material", "mobility", "frontier", "vulnerability", "edge", "blocked_safety", "parity"
+    };
+
+    constexpr Bitboard rimCells() {
+        Bitboard mask = 0;
+        for (int cell = 0; cell < BoardGeometry::cellCount; cell++) {
+            if (Topology::of(cell).neighborCount < 6) mask |= cellBit(cell);
+        }
+        return mask;
+    }
+
+    constexpr Bitboard rim = rimCells();
+}
+
+const char* evalTermName(EvalTerm term) {
+    return termNames[term];
+}
+
+EvalFeatures evalFeatures(const Position& position, int side) {
+    Bitboard empty = position.empty();
+    Bitboard nextToBlocked = neighbors(position.blocked);
+
+    EvalFeatures features{};
+    for (int who = 0; who < 2; who++) {
+        int sign = who == side ? 1 : -1;
+        Bitboard own = position.pieces[who];
+        Bitboard frontier = neighbors(own) & empty;
+
+        features[Material] += sign * popcount(own);
+        features[Mobility] += sign * popcount(position.reachable(who));
+        features[Frontier] += sign * popcount(frontier);
+        features[Vulnerability] += sign * popcount(frontier & position.reachable(who ^ 1));
+        features[Edge] += sign * popcount(own & rim);
+        features[BlockedSafety] += sign * popcount(own & nextToBlocked);
+    }
+    features[Parity] = (popcount(empty) & 1) ? 1 : -1;
+    return features;
+}
+
+int evaluate(const Position& position, int side, const EvalWeights& weights) {
+    EvalFeatures features = evalFeatures(position, side);
+    int score = 0;
+    for (int term = 0; term < evalTermCount; term++) {
+        score += weights.values[term] * features[term];
+    }
+    return score;
+}
+
+double expectedResult(int score) {
+    return 1.0 / (1.0 + std::exp(-expectedResultScale * score));
+}
+
+int scoreForExpectedResult(double result) {
+    // a sure result would be infinitely many pieces; 1% off it is about 25
+    result = std::clamp(result, 0.01, 0.99);
+    return static_cast<int>(std::lround(std::log(result / (1.0 - result)) / expectedResultScale));
+}
+
+void writeEvalWeights(const EvalWeights& weights, const std::string& filename) {
+    std::ofstream file(filename);
+    if (!file.is_open()) {
+        throw std::runtime_error("Unable to open file for saving.");
+    }
+
+    for (int term = 0; term < evalTermCount; term++) {
+        file << termNames[term] << ' ' << weights.values[term] << '\n';
+    }
+}
+
+std::optional<EvalWeights> readEvalWeights(const std::string& filename) {
+    std::ifstream file(filename);
+    if (!file.is_open()) {
+        return std::nullopt;
+    }
+
+    EvalWeights weights;
+    for (std::string line; std::getline(file, line);) {
+        std::istringstream stream(line);
+        std::string name, rest;
+        int value;
+        if (!(stream >> name)) continue;
+        if (!(stream >> value) || stream >> rest) {
+            return std::nullopt;
+        }
+
+        auto found = std::find(std::begin(termNames), std::end(termNames), std::string_view(name));
+        if (found == std::end(termNames)) {
+            return std::nullopt;
+        }
+        weights.values[found - std::begin(termNames)] = value;
+    }
+    return weights;
+}
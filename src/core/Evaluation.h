@@ -0,0 +1,55 @@
+#pragma once
+
+#include <array>
+#include <optional>
+#include <string>
+
+#include "Position.h"
+
+// Terms of the static evaluation. Each is the side to move's count minus the opponent's.
+enum EvalTerm {
+    Material,       // pieces
+    Mobility,       // empty cells the side can clone or jump into
+    Frontier,       // empty cells next to the side's pieces
+    Vulnerability,  // of those, the ones the opponent can move into
+    Edge,           // pieces on the rim, which have fewer neighbours to be captured from
+    BlockedSafety,  // pieces next to blocked cells
+    Parity,         // 1 when the number of empty cells is odd and the side to move fills the last one, else -1
+    evalTermCount
+};
+
+using EvalFeatures = std::array<int, evalTermCount>;
+
+// A piece in evaluation units.
+constexpr int pieceScore = 100;
+
+// Slope of the logistic from a score to the side to move's expected result, as fitted by
+// hexagon-tune to 5000 games of depth 2 and 3 searches with the default weights.
+constexpr double expectedResultScale = 0.00185;
+
+// Weights of the evaluation terms in hundredths of a piece. The defaults were fitted by
+// hexagon-tune to 4000 games of depth 2 and 3 searches that counted material only.
+struct EvalWeights {
+    std::array<int, evalTermCount> values = {96, 13, -21, -22, 26, 12, -4};
+
+    int operator[](EvalTerm term) const { return values[term]; }
+};
+
+inline const std::string defaultEvalWeightsFile = "eval.weights";
+
+const char* evalTermName(EvalTerm term);
+
+EvalFeatures evalFeatures(const Position& position, int side);
+int evaluate(const Position& position, int side, const EvalWeights& weights);
+
+// Expected result for the side to move, 0 (loss) to 1 (win), of a score, and back; lets
+// game statistics and MCTS win rates be reported in evaluation units.
+double expectedResult(int score);
+int scoreForExpectedResult(double result);
+
+// One "name value" pair per line.
+// Throws std::runtime_error when the file cannot be written.
+void writeEvalWeights(const EvalWeights& weights, const std::string& filename = defaultEvalWeightsFile);
+// Missing terms keep their default weight; nullopt when the file is missing, names an unknown
+// term or has a line that is not a name and a whole number.
+std::optional<EvalWeights> readEvalWeights(const std::string& filename = defaultEvalWeightsFile);
@@ -0,0 +1,75 @@
+#include "Layout.h"
+
+#include <algorithm>
+#include <fstream>
+#include <sstream>
+
+namespace {
+    std::optional<CellState> cellState(char symbol) {
+        switch (symbol) {
+            case '.': return CellState::Empty;
+            case '#': return CellState::Blocked;
+            case '1': return CellState::Player1;
+            case '2': return CellState::Player2;
+            default: return std::nullopt;
+        }
+    }
+}
+
+BoardLayout standardLayout() {
+    return layoutOf(startingPosition());
+}
+
+BoardLayout layoutOf(const Position& position) {
+    BoardLayout layout;
+    layout.position = position;
+
+    Bitboard open = position.empty() | position.pieces[0] | position.pieces[1];
+    while (open) {
+        int cell = popLsb(open);
+        layout.rows = std::max(layout.rows, cellRow(cell) + 1);
+        layout.cols = std::max(layout.cols, cellCol(cell) + 1);
+    }
+    return layout;
+}
+
+std::optional<BoardLayout> readLayoutFile(const std::string& filename) {
+    std::ifstream file(filename);
+    if (!file.is_open()) {
+        return std::nullopt;
+    }
+
+    std::stringstream text;
+    for (std::string line; std::getline(file, line);) {
+        text << line.substr(0, line.find(';')) << '\n';
+    }
+
+    BoardLayout layout;
+    if (!(text >> layout.rows >> layout.cols) || layout.rows < 1 || layout.cols < 1
+        || layout.rows > BoardGeometry::rows || layout.cols > BoardGeometry::cols) {
+        return std::nullopt;
+    }
+
+    for (int cell = 0; cell < BoardGeometry::cellCount; cell++) {
+        layout.position.setState(cell, CellState::Blocked);
+    }
+    for (int row = 0; row < layout.rows; row++) {
+        for (int col = 0; col < layout.cols; col++) {
+            char symbol;
+            if (!(text >> symbol)) {
+                return std::nullopt;
+            }
+            auto state = cellState(symbol);
+            if (!state) {
+                return std::nullopt;
+            }
+            layout.position.setState(cellIndex(row, col), *state);
+        }
+    }
+
+    char extra;
+    if (text >> extra || layout.position.pieces[0] == 0 || layout.position.pieces[1] == 0) {
+        return std::nullopt;
+    }
+    return layout;
+}
@@ -0,0 +1,25 @@
+#pragma once
+
+#include <optional>
+#include <string>
+
+#include "Position.h"
+
+// A board shape and its starting pieces, placed in the top-left corner of the grid; the grid
+// cells it leaves out are blocked.
+struct BoardLayout {
+    int rows = 0;
+    int cols = 0;
+    Position position;
+};
+
+// The standard 9x9 board of startingPosition().
+BoardLayout standardLayout();
+
+// The smallest layout holding every cell of position that is not blocked.
+BoardLayout layoutOf(const Position& position);
+
+// Text file: "rows cols", then rows * cols cells in row-major order, whitespace ignored:
+// '.' empty, '#' blocked, '1' and '2' the players' pieces. ';' starts a comment.
+// nullopt when the file is missing, malformed, larger than the grid or leaves a side without pieces
+std::optional<BoardLayout> readLayoutFile(const std::string& filename);
@@ -0,0 +1,394 @@
+#include "Mcts.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <thread>
+
+#include "Evaluation.h"
+
+namespace {
+    // playouts that run this long are scored by material
+    constexpr int maxPlayoutPlies = 200;
+    constexpr int maxTreeDepth = 128;
+
+    enum : uint8_t { Unexpanded, Expanding, Expanded, Full };
+
+    uint64_t nextRandom(uint64_t& state) {
+        state ^= state >> 12;
+        state ^= state << 25;
+        state ^= state >> 27;
+        return state * 0x2545F4914F6CDD1Dull;
+    }
+
+    int randomBelow(uint64_t& state, int bound) {
+        return static_cast<int>((nextRandom(state) >> 32) * bound >> 32);
+    }
+
+    int randomCell(Bitboard cells, uint64_t& state) {
+        for (int skip = randomBelow(state, popcount(cells)); skip > 0; skip--) {
+            cells &= cells - 1;
+        }
+        return lsb(cells);
+    }
+
+    // Best immediate gain, a clone counting its new piece, read off the capture counts of
+    // every cell at once instead of scoring the moves one by one. Ties go to a random target
+    // cell, and a jump to a random piece that can make it. The side must have a move.
+    Move greedyMove(const Position& position, int side, uint64_t& rng) {
+        Bitboard own = position.pieces[side];
+        Bitboard empty = position.empty();
+        Bitboard cloneTargets = neighbors(own) & empty;
+        // cloning into a cell always gains one more than jumping into it
+        Bitboard jumpTargets = neighbors(neighbors(own)) & empty & ~cloneTargets;
+        NeighborCounts captures = neighborCounts(position.pieces[side ^ 1]);
+
+        for (int gain = 7; gain >= 0; gain--) {
+            Bitboard clones = gain > 0 ? cloneTargets & captures.equal(gain - 1) : 0;
+            Bitboard jumps = gain < 7 ? jumpTargets & captures.equal(gain) : 0;
+            if (!(clones | jumps)) continue;
+
+            int to = randomCell(clones | jumps, rng);
+            if (clones & cellBit(to)) {
+                return {static_cast<uint8_t>(lsb(Topology::of(to).neighborMask & own)), static_cast<uint8_t>(to),
+                        MoveType::Clone};
+            }
+            int from = randomCell(Topology::of(to).jumpMask & own, rng);
+            return {static_cast<uint8_t>(from), static_cast<uint8_t>(to), MoveType::Move};
+        }
+        return {};
+    }
+}
+
+struct MctsEngine::Node {
+    Move move;
+    uint8_t side = 0;  // to move at this node
+    std::atomic<uint8_t> state = Unexpanded;
+    // valid once state is Expanded
+    int32_t firstChild = -1;
+    int32_t childCount = 0;
+    std::atomic<uint32_t> visits = 0;
+    std::atomic<uint32_t> virtualLoss = 0;
+    // 2 per win and 1 per draw for the side that made move
+    std::atomic<uint64_t> reward = 0;
+
+    void reset(const Move& move, int side) {
+        this->move = move;
+        this->side = static_cast<uint8_t>(side);
+        state.store(Unexpanded, std::memory_order_relaxed);
+        firstChild = -1;
+        childCount = 0;
+        visits.store(0, std::memory_order_relaxed);
+        virtualLoss.store(0, std::memory_order_relaxed);
+        reward.store(0, std::memory_order_relaxed);
+    }
+};
+
+MctsEngine::MctsEngine(int threads, int maxNodes)
+    : nodes(std::make_unique<Node[]>(maxNodes)), spare(std::make_unique<Node[]>(maxNodes)), maxNodes(maxNodes) {
+    setThreads(threads);
+}
+
+MctsEngine::~MctsEngine() = default;
+
+void MctsEngine::clearTree() {
+    hasTree = false;
+    nodeCount = 0;
+}
+
+int MctsEngine::newNodes(int count) {
+    int first = nodeCount.fetch_add(count, std::memory_order_relaxed);
+    if (first + count > maxNodes) {
+        return -1;
+    }
+    return first;
+}
+
+MctsResult MctsEngine::search(const Position& position, CellState player, const MctsLimits& limits) {
+    auto startTime = std::chrono::steady_clock::now();
+    int side = Position::side(player);
+
+    if (book) {
+        if (auto entry = book->probe(position, side, position.key ^ searchCount++)) {
+            MctsResult result;
+            result.bestMove = entry->move();
+            result.winRate = expectedResult(entry->score);
+            result.pv = {result.bestMove};
+            result.fromBook = true;
+            return result;
+        }
+    }
+
+    if (!reuseTree(position, side)) {
+        rootPosition = position;
+        rootSide = side;
+        nodeCount = 0;
+        nodes[newNodes(1)].reset(Move(), side);
+        hasTree = true;
+    }
+
+    stopped = false;
+    iterations = 0;
+    searchCount++;
+
+    std::vector<std::thread> helpers;
+    for (int id = 1; id < threads; id++) {
+        helpers.emplace_back(&MctsEngine::worker, this, id, std::cref(limits));
+    }
+    worker(0, limits);
+    for (auto& helper : helpers) {
+        helper.join();
+    }
+
+    MctsResult result;
+    result.iterations = iterations;
+    result.rootVisits = nodes[0].visits;
+    result.treeNodes = std::min(nodeCount.load(), maxNodes);
+
+    // most visited line
+    int node = 0;
+    while (nodes[node].state.load(std::memory_order_acquire) == Expanded && nodes[node].childCount > 0
+           && result.pv.size() < 32) {
+        int best = -1;
+        for (int child = nodes[node].firstChild; child < nodes[node].firstChild + nodes[node].childCount; child++) {
+            if (best < 0 || nodes[child].visits > nodes[best].visits) best = child;
+        }
+        if (nodes[best].visits == 0) break;
+
+        if (node == 0) {
+            result.winRate = nodes[best].reward / (2.0 * nodes[best].visits);
+        }
+        result.pv.push_back(nodes[best].move);
+        node = best;
+    }
+    result.bestMove = result.pv.empty() ? Move() : result.pv.front();
+
+    result.timeMs = static_cast<int>(std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::steady_clock::now() - startTime).count());
+    return result;
+}
+
+void MctsEngine::worker(int id, const MctsLimits& limits) {
+    auto startTime = std::chrono::steady_clock::now();
+    uint64_t rng = (searchCount * 0x9E3779B97F4A7C15ull) ^ ((id + 1) * 0xD1B54A32D192ED03ull);
+
+    for (uint64_t done = 0; !stopped; done++) {
+        iterate(rng);
+
+        uint64_t total = iterations.fetch_add(1, std::memory_order_relaxed) + 1;
+        if (limits.iterations > 0 && total >= static_cast<uint64_t>(limits.iterations)) {
+            stopped = true;
+        }
+        if (limits.stopSignal && limits.stopSignal->load(std::memory_order_relaxed)) {
+            stopped = true;
+        }
+        if (limits.timeMs > 0 && (done & 63) == 0) {
+            auto elapsed = std::chrono::steady_clock::now() - startTime;
+            if (elapsed >= std::chrono::milliseconds(limits.timeMs)) {
+                stopped = true;
+            }
+        }
+    }
+}
+
+void MctsEngine::iterate(uint64_t& rng) {
+    Position position = rootPosition;
+    int side = rootSide;
+
+    int path[maxTreeDepth];
+    int length = 0;
+    int node = 0;
+    path[length++] = node;
+
+    while (length < maxTreeDepth) {
+        uint8_t state = nodes[node].state.load(std::memory_order_acquire);
+
+        if (state == Unexpanded || state == Expanding) {
+            if (state == Expanding || !expand(node, position)) break;
+        } else if (state == Full) {
+            break;
+        }
+        if (nodes[node].childCount == 0) break;
+
+        int child = select(node);
+        nodes[child].virtualLoss.fetch_add(1, std::memory_order_relaxed);
+        Undo undo;
+        position.makeMove(side, nodes[child].move, undo);
+        side ^= 1;
+        path[length++] = child;
+        node = child;
+
+        // a fresh child is played out before it gets children of its own
+        if (nodes[child].visits.load(std::memory_order_relaxed) == 0) break;
+    }
+
+    int winner = playout(position, side, rng);
+
+    for (int i = 0; i < length; i++) {
+        Node& visited = nodes[path[i]];
+        int mover = visited.side ^ 1;
+        uint64_t reward = winner < 0 ? 1 : (winner == mover ? 2 : 0);
+
+        visited.reward.fetch_add(reward, std::memory_order_relaxed);
+        visited.visits.fetch_add(1, std::memory_order_relaxed);
+        if (i > 0) {
+            visited.virtualLoss.fetch_sub(1, std::memory_order_relaxed);
+        }
+    }
+}
+
+int MctsEngine::select(int node) {
+    const Node& parent = nodes[node];
+    double parentVisits = parent.visits.load(std::memory_order_relaxed) + parent.virtualLoss.load(std::memory_order_relaxed);
+    double logVisits = std::log(std::max(parentVisits, 1.0));
+
+    int best = parent.firstChild;
+    double bestValue = -1.0;
+
+    for (int child = parent.firstChild; child < parent.firstChild + parent.childCount; child++) {
+        // a virtual loss counts as a visit that brought nothing
+        uint32_t visits = nodes[child].visits.load(std::memory_order_relaxed)
+            + nodes[child].virtualLoss.load(std::memory_order_relaxed);
+        if (visits == 0) return child;
+
+        double value = nodes[child].reward.load(std::memory_order_relaxed) / (2.0 * visits)
+            + exploration * std::sqrt(logVisits / visits);
+        if (value > bestValue) {
+            bestValue = value;
+            best = child;
+        }
+    }
+    return best;
+}
+
+bool MctsEngine::expand(int node, const Position& position) {
+    uint8_t expected = Unexpanded;
+    if (!nodes[node].state.compare_exchange_strong(expected, Expanding, std::memory_order_acquire)) {
+        return false;
+    }
+
+    int side = nodes[node].side;
+    MoveList moves;
+    if (!position.isGameOver(side)) {
+        position.generateMoves(side, moves);
+    }
+
+    int first = moves.size ? newNodes(moves.size) : 0;
+    if (first < 0) {
+        nodes[node].state.store(Full, std::memory_order_release);
+        return false;
+    }
+
+    for (int i = 0; i < moves.size; i++) {
+        nodes[first + i].reset(moves.moves[i], side ^ 1);
+    }
+    nodes[node].firstChild = first;
+    nodes[node].childCount = moves.size;
+    nodes[node].state.store(Expanded, std::memory_order_release);
+    return true;
+}
+
+int MctsEngine::playout(Position position, int side, uint64_t& rng) const {
+    for (int ply = 0; ply < maxPlayoutPlies; ply++) {
+        if (position.isGameOver(side)) {
+            int margin = position.finalMargin(side);
+            return margin > 0 ? 0 : margin < 0 ? 1 : -1;
+        }
+
+        Move move;
+        if (playoutPolicy == PlayoutPolicy::Random) {
+            MoveList moves;
+            position.generateMoves(side, moves);
+            move = moves.moves[randomBelow(rng, moves.size)];
+        } else {
+            move = greedyMove(position, side, rng);
+        }
+
+        Undo undo;
+        position.makeMove(side, move, undo);
+        side ^= 1;
+    }
+
+    int margin = position.count(CellState::Player1) - position.count(CellState::Player2);
+    return margin > 0 ? 0 : margin < 0 ? 1 : -1;
+}
+
+// Looks for the new position among the root's children and grandchildren.
+bool MctsEngine::reuseTree(const Position& position, int side) {
+    if (!hasTree) return false;
+
+    auto matches = [&](const Position& candidate, int candidateSide) {
+        return candidateSide == side && candidate.pieces[0] == position.pieces[0]
+            && candidate.pieces[1] == position.pieces[1] && candidate.blocked == position.blocked;
+    };
+
+    int found = -1;
+    if (matches(rootPosition, rootSide)) {
+        found = 0;
+    }
+
+    const Node& root = nodes[0];
+    if (found < 0 && root.state.load() == Expanded) {
+        for (int child = root.firstChild; found < 0 && child < root.firstChild + root.childCount; child++) {
+            Position afterChild = rootPosition;
+            afterChild.play(nodes[child].move);
+            if (matches(afterChild, rootSide ^ 1)) {
+                found = child;
+                break;
+            }
+
+            const Node& middle = nodes[child];
+            if (middle.state.load() != Expanded) continue;
+
+            for (int grandchild = middle.firstChild; grandchild < middle.firstChild + middle.childCount; grandchild++) {
+                Position afterGrandchild = afterChild;
+                afterGrandchild.play(nodes[grandchild].move);
+                if (matches(afterGrandchild, rootSide)) {
+                    found = grandchild;
+                    break;
+                }
+            }
+        }
+    }
+
+    if (found < 0) return false;
+
+    if (found > 0) {
+        int count = copySubtree(found, spare.get());
+        std::swap(nodes, spare);
+        nodeCount = count;
+    }
+
+    rootPosition = position;
+    rootSide = side;
+    return true;
+}
+
+// Breadth-first copy into target so that every child block stays contiguous.
+int MctsEngine::copySubtree(int node, Node* target) const {
+    auto copyNode = [&](const Node& from, Node& to) {
+        to.reset(from.move, from.side);
+        to.visits.store(from.visits.load(std::memory_order_relaxed), std::memory_order_relaxed);
+        to.reward.store(from.reward.load(std::memory_order_relaxed), std::memory_order_relaxed);
+    };
+
+    std::vector<std::pair<int, int>> queue = {{node, 0}};
+    copyNode(nodes[node], target[0]);
+    int count = 1;
+
+    for (size_t next = 0; next < queue.size(); next++) {
+        auto [from, to] = queue[next];
+        const Node& source = nodes[from];
+        if (source.state.load() != Expanded) continue;
+
+        target[to].firstChild = count;
+        target[to].childCount = source.childCount;
+        for (int i = 0; i < source.childCount; i++) {
+            copyNode(nodes[source.firstChild + i], target[count + i]);
+            queue.push_back({source.firstChild + i, count + i});
+        }
+        target[to].state.store(Expanded, std::memory_order_relaxed);
+        count += source.childCount;
+    }
+    return count;
+}
@@ -0,0 +1,88 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include "OpeningBook.h"
+#include "Position.h"
+
+enum class PlayoutPolicy { Random, Greedy };
+
+struct MctsLimits {
+    int iterations = 0;  // 0 - no iteration limit
+    int timeMs = 0;      // 0 - no time limit
+    // raised by another thread to abort the search
+    const std::atomic<bool>* stopSignal = nullptr;
+};
+
+struct MctsResult {
+    Move bestMove;
+    // expected result for the player to move, a draw counts half
+    double winRate = 0.0;
+    std::vector<Move> pv;
+    uint64_t iterations = 0;
+    // visits of the root, including those reused from the previous search
+    uint64_t rootVisits = 0;
+    int treeNodes = 0;
+    int timeMs = 0;
+    // played straight from the opening book without searching
+    bool fromBook = false;
+};
+
+// Monte Carlo tree search with UCT selection and random or greedy playouts.
+// Threads share one tree (tree parallelism); virtual losses steer them apart.
+// The tree is kept between searches and re-rooted when the new position is
+// a child or grandchild of the previous root.
+class MctsEngine {
+public:
+    static constexpr int defaultMaxNodes = 1 << 20;
+
+    explicit MctsEngine(int threads = 1, int maxNodes = defaultMaxNodes);
+    ~MctsEngine();
+
+    MctsEngine(const MctsEngine&) = delete;
+    MctsEngine& operator=(const MctsEngine&) = delete;
+
+    void setThreads(int count) { threads = count > 1 ? count : 1; }
+    void setPlayoutPolicy(PlayoutPolicy policy) { playoutPolicy = policy; }
+    void setExploration(double constant) { exploration = constant; }
+    void setOpeningBook(std::shared_ptr<const OpeningBook> book) { this->book = std::move(book); }
+    void clearTree();
+
+    MctsResult search(const Position& position, CellState player, const MctsLimits& limits);
+
+private:
+    struct Node;
+
+    void worker(int id, const MctsLimits& limits);
+    void iterate(uint64_t& rng);
+    int select(int node);
+    bool expand(int node, const Position& position);
+    // winning side of a playout from position, or -1 for a draw
+    int playout(Position position, int side, uint64_t& rng) const;
+
+    bool reuseTree(const Position& position, int side);
+    // returns the number of nodes copied
+    int copySubtree(int node, Node* target) const;
+    int newNodes(int count);
+
+    std::unique_ptr<Node[]> nodes;
+    std::unique_ptr<Node[]> spare;
+    int maxNodes;
+    std::atomic<int> nodeCount = 0;
+
+    Position rootPosition;
+    int rootSide = 0;
+    bool hasTree = false;
+
+    int threads = 1;
+    PlayoutPolicy playoutPolicy = PlayoutPolicy::Greedy;
+    double exploration = 1.0;
+    std::shared_ptr<const OpeningBook> book;
+
+    std::atomic<bool> stopped = false;
+    std::atomic<uint64_t> iterations = 0;
+    uint64_t searchCount = 0;
+};
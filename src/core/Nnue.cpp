@@ -0,0 +1,239 @@
+#include "Nnue.h"
+
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+
+#ifdef __AVX2__
+#include <immintrin.h>
+#endif
+
+using namespace NnueLayout;
+
+namespace {
+    constexpr char magic[8] = {'H', 'E', 'X', 'N', 'N', 'U', 'E', '1'};
+    constexpr int32_t layerSizes[3] = {inputs, hidden, layer2};
+
+    int feature(int perspective, int owner, int cell) {
+        return (owner == perspective ? 0 : BoardGeometry::cellCount) + cell;
+    }
+
+    // Input rows a move adds and removes for one perspective: the moved piece, the jump's
+    // origin and up to six captures.
+    struct Delta {
+        int added[8];
+        int removed[8];
+        int addedCount = 0;
+        int removedCount = 0;
+    };
+
+    void applyDelta(const NnueNetwork& network, const int16_t* parent, int16_t* child, const Delta& delta) {
+#ifdef __AVX2__
+        constexpr int registers = hidden / 16;
+        __m256i sums[registers];
+        for (int i = 0; i < registers; i++) {
+            sums[i] = _mm256_load_si256(reinterpret_cast<const __m256i*>(parent) + i);
+        }
+        for (int j = 0; j < delta.addedCount; j++) {
+            auto row = reinterpret_cast<const __m256i*>(network.inputWeights[delta.added[j]]);
+            for (int i = 0; i < registers; i++) {
+                sums[i] = _mm256_add_epi16(sums[i], _mm256_load_si256(row + i));
+            }
+        }
+        for (int j = 0; j < delta.removedCount; j++) {
+            auto row = reinterpret_cast<const __m256i*>(network.inputWeights[delta.removed[j]]);
+            for (int i = 0; i < registers; i++) {
+                sums[i] = _mm256_sub_epi16(sums[i], _mm256_load_si256(row + i));
+            }
+        }
+        for (int i = 0; i < registers; i++) {
+            _mm256_store_si256(reinterpret_cast<__m256i*>(child) + i, sums[i]);
+        }
+#else
+        std::memcpy(child, parent, hidden * sizeof(int16_t));
+        for (int j = 0; j < delta.addedCount; j++) {
+            const int16_t* row = network.inputWeights[delta.added[j]];
+            for (int i = 0; i < hidden; i++) child[i] += row[i];
+        }
+        for (int j = 0; j < delta.removedCount; j++) {
+            const int16_t* row = network.inputWeights[delta.removed[j]];
+            for (int i = 0; i < hidden; i++) child[i] -= row[i];
+        }
+#endif
+    }
+
+    // Clipped ReLU from the accumulator's int16 to the dense layers' uint8.
+    void clip(const int16_t* values, uint8_t* out) {
+#ifdef __AVX2__
+        const __m256i top = _mm256_set1_epi8(activationOne);
+        for (int i = 0; i < hidden; i += 32) {
+            __m256i low = _mm256_load_si256(reinterpret_cast<const __m256i*>(values + i));
+            __m256i high = _mm256_load_si256(reinterpret_cast<const __m256i*>(values + i + 16));
+            // packus works within 128-bit lanes, the permute puts the quarters back in order
+            __m256i packed = _mm256_permute4x64_epi64(_mm256_packus_epi16(low, high), 0xD8);
+            _mm256_store_si256(reinterpret_cast<__m256i*>(out + i), _mm256_min_epu8(packed, top));
+        }
+#else
+        for (int i = 0; i < hidden; i++) {
+            out[i] = static_cast<uint8_t>(std::clamp<int>(values[i], 0, activationOne));
+        }
+#endif
+    }
+
+    // size is a multiple of 32
+    int32_t dot(const uint8_t* activations, const int8_t* weights, int size) {
+#ifdef __AVX2__
+        const __m256i ones = _mm256_set1_epi16(1);
+        __m256i sum = _mm256_setzero_si256();
+        for (int i = 0; i < size; i += 32) {
+            __m256i a = _mm256_load_si256(reinterpret_cast<const __m256i*>(activations + i));
+            __m256i w = _mm256_load_si256(reinterpret_cast<const __m256i*>(weights + i));
+            // pairs of 127 * -128 still fit in int16, so maddubs never saturates here
+            sum = _mm256_add_epi32(sum, _mm256_madd_epi16(_mm256_maddubs_epi16(a, w), ones));
+        }
+        __m128i half = _mm_add_epi32(_mm256_castsi256_si128(sum), _mm256_extracti128_si256(sum, 1));
+        half = _mm_add_epi32(half, _mm_shuffle_epi32(half, 0x4E));
+        half = _mm_add_epi32(half, _mm_shuffle_epi32(half, 0xB1));
+        return _mm_cvtsi128_si32(half);
+#else
+        int32_t sum = 0;
+        for (int i = 0; i < size; i++) {
+            sum += activations[i] * weights[i];
+        }
+        return sum;
+#endif
+    }
+
+    // The hidden layer's sums before the bias. With AVX2 four rows share one horizontal reduction.
+    void hiddenLayer(const NnueNetwork& network, const uint8_t* input, int32_t* sums) {
+#ifdef __AVX2__
+        const __m256i ones = _mm256_set1_epi16(1);
+        auto multiplyAdd = [&](__m256i sum, __m256i a, int row, int i) {
+            __m256i w = _mm256_load_si256(reinterpret_cast<const __m256i*>(network.hiddenWeights[row] + i));
+            return _mm256_add_epi32(sum, _mm256_madd_epi16(_mm256_maddubs_epi16(a, w), ones));
+        };
+
+        for (int row = 0; row < layer2; row += 4) {
+            // named rather than an array so the sums stay in registers
+            __m256i sum0 = _mm256_setzero_si256();
+            __m256i sum1 = _mm256_setzero_si256();
+            __m256i sum2 = _mm256_setzero_si256();
+            __m256i sum3 = _mm256_setzero_si256();
+            for (int i = 0; i < 2 * hidden; i += 32) {
+                __m256i a = _mm256_load_si256(reinterpret_cast<const __m256i*>(input + i));
+                sum0 = multiplyAdd(sum0, a, row, i);
+                sum1 = multiplyAdd(sum1, a, row + 1, i);
+                sum2 = multiplyAdd(sum2, a, row + 2, i);
+                sum3 = multiplyAdd(sum3, a, row + 3, i);
+            }
+            __m256i reduced = _mm256_hadd_epi32(_mm256_hadd_epi32(sum0, sum1), _mm256_hadd_epi32(sum2, sum3));
+            __m128i total = _mm_add_epi32(_mm256_castsi256_si128(reduced), _mm256_extracti128_si256(reduced, 1));
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(sums + row), total);
+        }
+#else
+        for (int row = 0; row < layer2; row++) {
+            sums[row] = dot(input, network.hiddenWeights[row], 2 * hidden);
+        }
+#endif
+    }
+
+    template <typename T>
+    bool readArray(std::ifstream& file, T* data, size_t count) {
+        return static_cast<bool>(file.read(reinterpret_cast<char*>(data), count * sizeof(T)));
+    }
+
+    template <typename T>
+    void writeArray(std::ofstream& file, const T* data, size_t count) {
+        file.write(reinterpret_cast<const char*>(data), count * sizeof(T));
+    }
+}
+
+std::shared_ptr<NnueNetwork> NnueNetwork::load(const std::string& path) {
+    std::ifstream file(path, std::ios::binary);
+    if (!file.is_open()) {
+        return nullptr;
+    }
+
+    char header[sizeof(magic)];
+    int32_t sizes[3];
+    if (!readArray(file, header, sizeof(header)) || std::memcmp(header, magic, sizeof(magic)) != 0
+        || !readArray(file, sizes, 3) || !std::equal(sizes, sizes + 3, layerSizes)) {
+        return nullptr;
+    }
+
+    auto network = std::make_shared<NnueNetwork>();
+    bool complete = readArray(file, &network->inputWeights[0][0], inputs * hidden)
+        && readArray(file, network->inputBias, hidden)
+        && readArray(file, &network->hiddenWeights[0][0], layer2 * 2 * hidden)
+        && readArray(file, network->hiddenBias, layer2)
+        && readArray(file, network->outputWeights, layer2)
+        && readArray(file, &network->outputBias, 1);
+    return complete ? network : nullptr;
+}
+
+bool NnueNetwork::write(const std::string& path) const {
+    std::ofstream file(path, std::ios::binary);
+    if (!file.is_open()) {
+        return false;
+    }
+
+    writeArray(file, magic, sizeof(magic));
+    writeArray(file, layerSizes, 3);
+    writeArray(file, &inputWeights[0][0], inputs * hidden);
+    writeArray(file, inputBias, hidden);
+    writeArray(file, &hiddenWeights[0][0], layer2 * 2 * hidden);
+    writeArray(file, hiddenBias, layer2);
+    writeArray(file, outputWeights, layer2);
+    writeArray(file, &outputBias, 1);
+    return static_cast<bool>(file);
+}
+
+void NnueNetwork::refresh(const Position& position, NnueAccumulator& accumulator) const {
+    for (int perspective = 0; perspective < 2; perspective++) {
+        int16_t* values = accumulator.values[perspective];
+        std::copy(inputBias, inputBias + hidden, values);
+
+        for (int owner = 0; owner < 2; owner++) {
+            Bitboard pieces = position.pieces[owner];
+            while (pieces) {
+                const int16_t* row = inputWeights[feature(perspective, owner, popLsb(pieces))];
+                for (int i = 0; i < hidden; i++) values[i] += row[i];
+            }
+        }
+    }
+}
+
+void NnueNetwork::update(const NnueAccumulator& parent, NnueAccumulator& child, int side, const Undo& undo) const {
+    for (int perspective = 0; perspective < 2; perspective++) {
+        Delta delta;
+        delta.added[delta.addedCount++] = feature(perspective, side, undo.to);
+        if (undo.type == MoveType::Move) {
+            delta.removed[delta.removedCount++] = feature(perspective, side, undo.from);
+        }
+
+        Bitboard captured = undo.captured;
+        while (captured) {
+            int cell = popLsb(captured);
+            delta.added[delta.addedCount++] = feature(perspective, side, cell);
+            delta.removed[delta.removedCount++] = feature(perspective, side ^ 1, cell);
+        }
+
+        applyDelta(*this, parent.values[perspective], child.values[perspective], delta);
+    }
+}
+
+int NnueNetwork::evaluate(const NnueAccumulator& accumulator, int side) const {
+    alignas(32) uint8_t input[2 * hidden];
+    clip(accumulator.values[side], input);
+    clip(accumulator.values[side ^ 1], input + hidden);
+
+    int32_t sums[layer2];
+    hiddenLayer(*this, input, sums);
+
+    alignas(32) uint8_t middle[layer2];
+    for (int i = 0; i < layer2; i++) {
+        middle[i] = static_cast<uint8_t>(std::clamp((hiddenBias[i] + sums[i]) / weightScale, 0, activationOne));
+    }
+
+    return (outputBias + dot(middle, outputWeights, layer2)) / outputDivisor;
+}
@@ -0,0 +1,51 @@
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <string>
+
+#include "Position.h"
+
+namespace NnueLayout {
+    // each perspective sees its own pieces in the first cellCount inputs and the opponent's in the rest
+    constexpr int inputs = 2 * BoardGeometry::cellCount;
+    constexpr int hidden = 128;
+    constexpr int layer2 = 32;
+
+    // fixed-point scales: activations run 0..activationOne, weights are multiplied by weightScale
+    constexpr int activationOne = 127;
+    constexpr int weightScale = 64;
+    // the output layer's sum divided by this is the score in hundredths of a piece
+    constexpr int outputDivisor = 16;
+}
+
+// First-layer sums of both perspectives, kept up to date move by move.
+struct alignas(32) NnueAccumulator {
+    int16_t values[2][NnueLayout::hidden];
+};
+
+// Small quantised evaluation network: 2x81 cell occupancy -> 128 per perspective (side to
+// move first) -> 32 -> 1, clipped ReLU in between. A move changes at most 8 cells, so the
+// search updates the first layer incrementally and only the two small dense layers run per
+// evaluation, with AVX2 when the build enables it.
+//
+// File: "HEXNNUE1", the layer sizes as three int32, then every array below in order,
+// little-endian.
+class NnueNetwork {
+public:
+    // nullptr when the file is missing, malformed or built for other layer sizes
+    static std::shared_ptr<NnueNetwork> load(const std::string& path);
+    bool write(const std::string& path) const;
+
+    void refresh(const Position& position, NnueAccumulator& accumulator) const;
+    // child becomes parent after side made the move recorded in undo
+    void update(const NnueAccumulator& parent, NnueAccumulator& child, int side, const Undo& undo) const;
+    int evaluate(const NnueAccumulator& accumulator, int side) const;
+
+    alignas(32) int16_t inputWeights[NnueLayout::inputs][NnueLayout::hidden] = {};
+    alignas(32) int16_t inputBias[NnueLayout::hidden] = {};
+    alignas(32) int8_t hiddenWeights[NnueLayout::layer2][2 * NnueLayout::hidden] = {};
+    alignas(32) int32_t hiddenBias[NnueLayout::layer2] = {};
+    alignas(32) int8_t outputWeights[NnueLayout::layer2] = {};
+    int32_t outputBias = 0;
+};
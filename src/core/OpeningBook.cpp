@@ -0,0 +1,165 @@
+#include "OpeningBook.h"
+
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace {
+    constexpr char magic[8] = {'H', 'E', 'X', 'B', 'O', 'O', 'K', '1'};
+
+    struct Header {
+        char magic[8];
+        uint64_t count;
+    };
+
+    static_assert(sizeof(Header) == 16);
+
+    bool isLegal(const Position& position, int side, const Move& move) {
+        Bitboard target = cellBit(move.to) & position.empty();
+        if (!(position.pieces[side] & cellBit(move.from)) || !target) return false;
+
+        const CellTopology& from = Topology::of(move.from);
+        return move.type == MoveType::Clone ? (from.neighborMask & target) != 0 : (from.jumpMask & target) != 0;
+    }
+}
+
+OpeningBook::~OpeningBook() {
+    close();
+}
+
+bool OpeningBook::open(const std::string& path) {
+    close();
+
+#ifdef _WIN32
+    HANDLE file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING,
+                              FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (file == INVALID_HANDLE_VALUE) return false;
+
+    LARGE_INTEGER fileSize;
+    if (!GetFileSizeEx(file, &fileSize) || fileSize.QuadPart < static_cast<LONGLONG>(sizeof(Header))) {
+        CloseHandle(file);
+        return false;
+    }
+
+    HANDLE view = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    void* data = view ? MapViewOfFile(view, FILE_MAP_READ, 0, 0, 0) : nullptr;
+    if (!data) {
+        if (view) CloseHandle(view);
+        CloseHandle(file);
+        return false;
+    }
+
+    fileHandle = file;
+    mappingHandle = view;
+    mapping = data;
+    mappingSize = static_cast<size_t>(fileSize.QuadPart);
+#else
+    int file = ::open(path.c_str(), O_RDONLY);
+    if (file < 0) return false;
+
+    struct stat info;
+    if (fstat(file, &info) != 0 || info.st_size < static_cast<off_t>(sizeof(Header))) {
+        ::close(file);
+        return false;
+    }
+
+    void* data = mmap(nullptr, info.st_size, PROT_READ, MAP_SHARED, file, 0);
+    ::close(file);
+    if (data == MAP_FAILED) return false;
+
+    mapping = data;
+    mappingSize = static_cast<size_t>(info.st_size);
+#endif
+
+    Header header;
+    std::memcpy(&header, mapping, sizeof(header));
+    if (std::memcmp(header.magic, magic, sizeof(magic)) != 0
+        || header.count != (mappingSize - sizeof(Header)) / sizeof(BookEntry)) {
+        close();
+        return false;
+    }
+
+    entries = reinterpret_cast<const BookEntry*>(static_cast<const char*>(mapping) + sizeof(Header));
+    count = header.count;
+    return true;
+}
+
+void OpeningBook::close() {
+    if (mapping) {
+#ifdef _WIN32
+        UnmapViewOfFile(mapping);
+        CloseHandle(mappingHandle);
+        CloseHandle(fileHandle);
+        mappingHandle = nullptr;
+        fileHandle = nullptr;
+#else
+        munmap(mapping, mappingSize);
+#endif
+    }
+    mapping = nullptr;
+    mappingSize = 0;
+    entries = nullptr;
+    count = 0;
+}
+
+std::span<const BookEntry> OpeningBook::find(uint64_t key) const {
+    auto byKey = [](const BookEntry& entry, uint64_t key) { return entry.key < key; };
+    const BookEntry* first = std::lower_bound(entries, entries + count, key, byKey);
+
+    const BookEntry* last = first;
+    while (last != entries + count && last->key == key) {
+        last++;
+    }
+    return {first, last};
+}
+
+std::optional<BookEntry> OpeningBook::probe(const Position& position, int side, uint64_t seed) const {
+    if (!isOpen()) return std::nullopt;
+
+    // a key collision could hand back moves of another position, so each one is checked
+    BookEntry legal[maxMoves];
+    int legalCount = 0;
+    uint64_t totalWeight = 0;
+    for (const BookEntry& entry : find(position.key ^ Zobrist::sideKey(side))) {
+        if (entry.weight > 0 && isLegal(position, side, entry.move()) && legalCount < maxMoves) {
+            legal[legalCount++] = entry;
+            totalWeight += entry.weight;
+        }
+    }
+    if (legalCount == 0) return std::nullopt;
+
+    uint64_t pick = Zobrist::splitmix64(seed) % totalWeight;
+    for (int i = 0; i < legalCount; i++) {
+        if (pick < legal[i].weight) return legal[i];
+        pick -= legal[i].weight;
+    }
+    return legal[legalCount - 1];
+}
+
+bool OpeningBook::write(const std::string& path, std::vector<BookEntry> records) {
+    std::sort(records.begin(), records.end(), [](const BookEntry& a, const BookEntry& b) {
+        return a.key != b.key ? a.key < b.key : a.weight > b.weight;
+    });
+
+    std::ofstream file(path, std::ios::binary);
+    if (!file.is_open()) return false;
+
+    Header header;
+    std::memcpy(header.magic, magic, sizeof(magic));
+    header.count = records.size();
+
+    file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    file.write(reinterpret_cast<const char*>(records.data()), records.size() * sizeof(BookEntry));
+    return static_cast<bool>(file);
+}
@@ -0,0 +1,64 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <span>
+#include <string>
+#include <vector>
+
+#include "Position.h"
+
+// One book move. Records are sorted by key, so all moves of a position are adjacent.
+struct BookEntry {
+    // Zobrist key with the side to move, as Position::key ^ Zobrist::sideKey(side)
+    uint64_t key = 0;
+    uint8_t from = 0;
+    uint8_t to = 0;
+    MoveType type = MoveType::Clone;
+    uint8_t reserved = 0;
+    // relative chance of playing this move
+    uint16_t weight = 0;
+    // score for the side to move in hundredths of a piece, from a search or game results
+    int16_t score = 0;
+
+    Move move() const { return {from, to, type}; }
+};
+
+static_assert(sizeof(BookEntry) == 16);
+
+// Read-only opening book mapped straight from its file: a 16-byte header followed by
+// BookEntry records sorted by key. Probes are a binary search over the mapping.
+class OpeningBook {
+public:
+    OpeningBook() = default;
+    ~OpeningBook();
+
+    OpeningBook(const OpeningBook&) = delete;
+    OpeningBook& operator=(const OpeningBook&) = delete;
+
+    bool open(const std::string& path);
+    void close();
+
+    bool isOpen() const { return entries != nullptr; }
+    size_t size() const { return count; }
+    std::span<const BookEntry> records() const { return {entries, count}; }
+
+    std::span<const BookEntry> find(uint64_t key) const;
+    // A legal book move picked at random by weight; seed makes the choice repeatable.
+    std::optional<BookEntry> probe(const Position& position, int side, uint64_t seed) const;
+
+    // Sorts the records and writes a book file.
+    static bool write(const std::string& path, std::vector<BookEntry> records);
+
+private:
+    const BookEntry* entries = nullptr;
+    size_t count = 0;
+
+    void* mapping = nullptr;
+    size_t mappingSize = 0;
+#ifdef _WIN32
+    void* fileHandle = nullptr;
+    void* mappingHandle = nullptr;
+#endif
+};
@@ -0,0 +1,293 @@
+#include "Position.h"
+
+namespace {
+    constexpr Bitboard columnsMask(int first, int step) {
+        Bitboard mask = 0;
+        for (int row = 0; row < BoardGeometry::rows; row++) {
+            for (int col = first; col < BoardGeometry::cols; col += step) {
+                mask |= cellBit(cellIndex(row, col));
+            }
+        }
+        return mask;
+    }
+
+    constexpr Bitboard boardMask = (Bitboard(1) << BoardGeometry::cellCount) - 1;
+    constexpr Bitboard notFirstCol = boardMask & ~columnsMask(0, BoardGeometry::cols);
+    constexpr Bitboard notLastCol = boardMask & ~columnsMask(BoardGeometry::cols - 1, BoardGeometry::cols);
+    constexpr Bitboard evenCols = columnsMask(0, 2);
+    constexpr Bitboard oddCols = columnsMask(1, 2);
+
+    constexpr int up = BoardGeometry::cols;
+
+    // 0 - empty, 1 - player1, 2 - player2, 3 - blocked
+    constexpr int standardSize = 9;
+    constexpr int startingLayout[standardSize * standardSize] = {
+        3, 3, 3, 0, 2, 0, 3, 3, 3,
+        3, 0, 0, 0, 0, 0, 0, 0, 3,
+        1, 0, 0, 0, 0, 0, 0, 0, 1,
+        0, 0, 0, 0, 3, 0, 0, 0, 0,
+        0, 0, 0, 3, 0, 3, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0, 0,
+        2, 0, 0, 0, 0, 0, 0, 0, 2,
+        3, 3, 0, 0, 0, 0, 0, 3, 3,
+        3, 3, 3, 3, 1, 3, 3, 3, 3
+    };
+
+    // Zobrist delta of moving every cell of cells from one side to the other
+    uint64_t flipKey(Bitboard cells) {
+        uint64_t delta = 0;
+        while (cells) {
+            int cell = popLsb(cells);
+            delta ^= Zobrist::pieces[0][cell] ^ Zobrist::pieces[1][cell];
+        }
+        return delta;
+    }
+}
+
+namespace {
+    // bb moved one step in each of the six directions. Even columns touch the row above on
+    // the diagonals and odd columns the row below, so each diagonal plane merges both
+    // parities; they land in different columns and never overlap.
+    struct DirectionPlanes {
+        Bitboard planes[6];
+    };
+
+    inline DirectionPlanes directionPlanes(Bitboard bb) {
+        Bitboard even = bb & evenCols;
+        Bitboard odd = bb & oddCols;
+        return {{
+            (bb << up) & boardMask,
+            bb >> up,
+            (bb & notLastCol) << 1,
+            (bb & notFirstCol) >> 1,
+            ((even & notLastCol) >> (up - 1)) | (((odd & notFirstCol) << (up - 1)) & boardMask),
+            ((even & notFirstCol) >> (up + 1)) | (((odd & notLastCol) << (up + 1)) & boardMask),
+        }};
+    }
+}
+
+Bitboard neighbors(Bitboard bb) {
+    DirectionPlanes d = directionPlanes(bb);
+    return d.planes[0] | d.planes[1] | d.planes[2] | d.planes[3] | d.planes[4] | d.planes[5];
+}
+
+// Two carry-save adders fold the six planes into pairs of sum and carry bits, and a third
+// adds those up, so every cell is counted in the same handful of bitwise operations.
+NeighborCounts neighborCounts(Bitboard cells) {
+    DirectionPlanes d = directionPlanes(cells);
+    auto sum = [](Bitboard a, Bitboard b, Bitboard c) { return a ^ b ^ c; };
+    auto carry = [](Bitboard a, Bitboard b, Bitboard c) { return (a & b) | (c & (a ^ b)); };
+
+    Bitboard sumA = sum(d.planes[0], d.planes[1], d.planes[2]);
+    Bitboard carryA = carry(d.planes[0], d.planes[1], d.planes[2]);
+    Bitboard sumB = sum(d.planes[3], d.planes[4], d.planes[5]);
+    Bitboard carryB = carry(d.planes[3], d.planes[4], d.planes[5]);
+
+    NeighborCounts counts;
+    counts.ones = sumA ^ sumB;
+    counts.twos = sum(carryA, carryB, sumA & sumB);
+    counts.fours = carry(carryA, carryB, sumA & sumB);
+    return counts;
+}
+
+Bitboard NeighborCounts::equal(int count) const {
+    return ((count & 1) ? ones : ~ones) & ((count & 2) ? twos : ~twos) & ((count & 4) ? fours : ~fours) & boardMask;
+}
+
+int connectedRegions(Bitboard cells, Bitboard* regions) {
+    int count = 0;
+    while (cells) {
+        Bitboard region = cells & (~cells + 1);
+        Bitboard grown = region;
+        do {
+            region = grown;
+            grown = (region | neighbors(region)) & cells;
+        } while (grown != region);
+
+        regions[count++] = region;
+        cells &= ~region;
+    }
+    return count;
+}
+
+CellState Position::getState(int cell) const {
+    Bitboard bit = cellBit(cell);
+    if (pieces[0] & bit) return CellState::Player1;
+    if (pieces[1] & bit) return CellState::Player2;
+    if (blocked & bit) return CellState::Blocked;
+    return CellState::Empty;
+}
+
+void Position::setState(int cell, CellState state) {
+    Bitboard bit = cellBit(cell);
+    if (pieces[0] & bit) key ^= Zobrist::pieces[0][cell];
+    if (pieces[1] & bit) key ^= Zobrist::pieces[1][cell];
+
+    pieces[0] &= ~bit;
+    pieces[1] &= ~bit;
+    blocked &= ~bit;
+
+    switch (state) {
+        case CellState::Player1:
+            pieces[0] |= bit;
+            key ^= Zobrist::pieces[0][cell];
+            break;
+        case CellState::Player2:
+            pieces[1] |= bit;
+            key ^= Zobrist::pieces[1][cell];
+            break;
+        case CellState::Blocked:
+            blocked |= bit;
+            break;
+        case CellState::Empty:
+            break;
+    }
+}
+
+Bitboard Position::empty() const {
+    return boardMask & ~(pieces[0] | pieces[1] | blocked);
+}
+
+Bitboard Position::cellsWithState(CellState state) const {
+    switch (state) {
+        case CellState::Player1:
+            return pieces[0];
+        case CellState::Player2:
+            return pieces[1];
+        case CellState::Blocked:
+            return blocked;
+        case CellState::Empty:
+            break;
+    }
+    return empty();
+}
+
+Bitboard Position::cloneTargets(int from) const {
+    return Topology::of(from).neighborMask & empty();
+}
+
+Bitboard Position::jumpTargets(int from) const {
+    return Topology::of(from).jumpMask & empty();
+}
+
+int Position::makeMove(int side, const Move& move, Undo& undo) {
+    Bitboard to = cellBit(move.to);
+    Bitboard captured = Topology::of(move.to).neighborMask & pieces[side ^ 1];
+
+    undo = {captured, key, move.from, move.to, move.type};
+
+    pieces[side ^ 1] &= ~captured;
+    pieces[side] |= captured | to;
+    key ^= Zobrist::pieces[side][move.to] ^ flipKey(captured);
+
+    if (move.type == MoveType::Move) {
+        pieces[side] &= ~cellBit(move.from);
+        key ^= Zobrist::pieces[side][move.from];
+        return popcount(captured);
+    }
+    return 1 + popcount(captured);
+}
+
+void Position::unmakeMove(int side, const Undo& undo) {
+    pieces[side] &= ~(undo.captured | cellBit(undo.to));
+    pieces[side ^ 1] |= undo.captured;
+    if (undo.type == MoveType::Move) {
+        pieces[side] |= cellBit(undo.from);
+    }
+    key = undo.key;
+}
+
+int Position::play(const Move& move) {
+    Undo undo;
+    return makeMove((pieces[0] & cellBit(move.from)) ? 0 : 1, move, undo);
+}
+
+int Position::clone(int from, int to) {
+    return play({static_cast<uint8_t>(from), static_cast<uint8_t>(to), MoveType::Clone});
+}
+
+int Position::jump(int from, int to) {
+    return play({static_cast<uint8_t>(from), static_cast<uint8_t>(to), MoveType::Move});
+}
+
+int Position::capture(int cell) {
+    int mover = (pieces[0] & cellBit(cell)) ? 0 : 1;
+    Bitboard captured = Topology::of(cell).neighborMask & pieces[mover ^ 1];
+    pieces[mover ^ 1] &= ~captured;
+    pieces[mover] |= captured;
+    key ^= flipKey(captured);
+    return popcount(captured);
+}
+
+Bitboard Position::reachable(int side) const {
+    Bitboard near = neighbors(pieces[side]) | pieces[side];
+    return neighbors(near) & empty();
+}
+
+int Position::emptyRegions(EmptyRegion* regions) const {
+    Bitboard cells[BoardGeometry::cellCount];
+    int count = connectedRegions(empty(), cells);
+
+    Bitboard reach[2] = {reachable(0), reachable(1)};
+    for (int i = 0; i < count; i++) {
+        regions[i].cells = cells[i];
+        regions[i].reachable[0] = (cells[i] & reach[0]) != 0;
+        regions[i].reachable[1] = (cells[i] & reach[1]) != 0;
+    }
+    return count;
+}
+
+void Position::generateMoves(int side, MoveList& list) const {
+    Bitboard own = pieces[side];
+    Bitboard emptyCells = empty();
+
+    Bitboard cloneCells = neighbors(own) & emptyCells;
+    while (cloneCells) {
+        int to = popLsb(cloneCells);
+        list.add(lsb(Topology::of(to).neighborMask & own), to, MoveType::Clone);
+    }
+
+    Bitboard movers = own;
+    while (movers) {
+        int from = popLsb(movers);
+        Bitboard targets = jumpTargets(from);
+        while (targets) {
+            list.add(from, popLsb(targets), MoveType::Move);
+        }
+    }
+}
+
+bool Position::isGameOver(int sideToMove) const {
+    return pieces[0] == 0 || pieces[1] == 0 || empty() == 0 || !hasMoves(sideToMove);
+}
+
+int Position::finalMargin(int sideToMove) const {
+    int margin = popcount(pieces[0]) - popcount(pieces[1]);
+    if (pieces[0] != 0 && pieces[1] != 0 && !hasMoves(sideToMove)) {
+        int rest = popcount(empty());
+        margin += sideToMove == 0 ? -rest : rest;
+    }
+    return margin;
+}
+
+uint64_t Position::computeKey() const {
+    uint64_t result = 0;
+    for (int side = 0; side < 2; side++) {
+        Bitboard bb = pieces[side];
+        while (bb) {
+            result ^= Zobrist::pieces[side][popLsb(bb)];
+        }
+    }
+    return result;
+}
+
+Position startingPosition() {
+    Position position;
+    for (int cell = 0; cell < BoardGeometry::cellCount; cell++) {
+        int row = cellRow(cell);
+        int col = cellCol(cell);
+        bool inside = row < standardSize && col < standardSize;
+        position.setState(cell, inside ? static_cast<CellState>(startingLayout[row * standardSize + col]) : CellState::Blocked);
+    }
+    return position;
+}
@@ -0,0 +1,154 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+
+#include "Topology.h"
+
+enum class CellState { Empty, Player1, Player2, Blocked };
+
+namespace Zobrist {
+    constexpr uint64_t splitmix64(uint64_t& state) {
+        uint64_t z = (state += 0x9E3779B97F4A7C15ull);
+        z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+        z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+        return z ^ (z >> 31);
+    }
+
+    constexpr std::array<std::array<uint64_t, BoardGeometry::cellCount>, 2> makePieceKeys() {
+        std::array<std::array<uint64_t, BoardGeometry::cellCount>, 2> keys{};
+        uint64_t state = 0x48657861676F6E;
+        for (auto& side : keys) {
+            for (auto& key : side) {
+                key = splitmix64(state);
+            }
+        }
+        return keys;
+    }
+
+    inline constexpr auto pieces = makePieceKeys();
+    inline constexpr uint64_t player2ToMove = 0xF1357AEA2E62A9C5ull;
+
+    constexpr uint64_t sideKey(int side) { return side == 0 ? 0 : player2ToMove; }
+}
+
+// All cells adjacent to any cell of bb, for whole-set dilation; single cells use Topology.
+Bitboard neighbors(Bitboard bb);
+
+// How many cells of a set border every cell of the board, as a 3-bit counter per cell kept in
+// three bit planes: the count at a cell is its bit in ones + 2 * twos + 4 * fours.
+// With the enemy pieces as the set, it is the capture gain of moving into each cell.
+struct NeighborCounts {
+    Bitboard ones = 0;
+    Bitboard twos = 0;
+    Bitboard fours = 0;
+
+    int at(int cell) const {
+        return static_cast<int>(bitboardWord(ones >> cell, 0) & 1) | static_cast<int>(bitboardWord(twos >> cell, 0) & 1) << 1
+            | static_cast<int>(bitboardWord(fours >> cell, 0) & 1) << 2;
+    }
+    // cells whose count is exactly count (0..6)
+    Bitboard equal(int count) const;
+};
+
+NeighborCounts neighborCounts(Bitboard cells);
+
+// Splits cells into connected groups; returns how many were written to regions (at most cellCount).
+int connectedRegions(Bitboard cells, Bitboard* regions);
+
+enum class MoveType : uint8_t { Clone, Move };
+
+struct Move {
+    uint8_t from = 0;
+    uint8_t to = 0;
+    MoveType type = MoveType::Clone;
+
+    bool isValid() const { return from != to; }
+    bool operator==(const Move&) const = default;
+};
+
+// Upper bound on legal moves: every clone target plus at most 12 jumps per empty cell,
+// scaled with the board area.
+constexpr int maxMoves = 512 * ((BoardGeometry::cellCount + 80) / 81);
+
+struct MoveList {
+    Move moves[maxMoves];
+    int size = 0;
+
+    void add(int from, int to, MoveType type) {
+        moves[size++] = {static_cast<uint8_t>(from), static_cast<uint8_t>(to), type};
+    }
+
+    Move* begin() { return moves; }
+    Move* end() { return moves + size; }
+};
+
+// A connected group of empty cells and which sides have a piece close enough to move into it.
+struct EmptyRegion {
+    Bitboard cells = 0;
+    bool reachable[2] = {false, false};
+
+    bool contested() const { return reachable[0] && reachable[1]; }
+};
+
+// Everything needed to take a move back.
+struct Undo {
+    Bitboard captured = 0;
+    uint64_t key = 0;
+    uint8_t from = 0;
+    uint8_t to = 0;
+    MoveType type = MoveType::Clone;
+};
+
+// Compact position: occupancy of both players plus the blocked cells of the layout.
+// Copying it is a plain memcpy of one cache line, so the AI can clone positions freely.
+struct Position {
+    Bitboard pieces[2] = {0, 0};
+    Bitboard blocked = 0;
+    // Zobrist key of the pieces, kept up to date by every mutation (side to move not included)
+    uint64_t key = 0;
+
+    static int side(CellState player) { return player == CellState::Player1 ? 0 : 1; }
+    static CellState player(int side) { return side == 0 ? CellState::Player1 : CellState::Player2; }
+
+    CellState getState(int cell) const;
+    void setState(int cell, CellState state);
+
+    Bitboard empty() const;
+    Bitboard cellsWithState(CellState state) const;
+    int count(CellState state) const { return popcount(cellsWithState(state)); }
+
+    Bitboard cloneTargets(int from) const;
+    Bitboard jumpTargets(int from) const;
+
+    // Each returns the change in the mover's piece count.
+    int makeMove(int side, const Move& move, Undo& undo);
+    void unmakeMove(int side, const Undo& undo);
+    int play(const Move& move);
+    int clone(int from, int to);
+    int jump(int from, int to);
+    int capture(int cell);
+
+    // Empty cells the side can clone or jump into.
+    Bitboard reachable(int side) const;
+    bool hasMoves(int side) const { return reachable(side) != 0; }
+
+    // Splits the empty cells into regions; returns how many were written (at most cellCount).
+    int emptyRegions(EmptyRegion* regions) const;
+
+    // Clones are generated once per target cell: every clone into it gives the same position.
+    void generateMoves(int side, MoveList& list) const;
+
+    // Over when a side is wiped out, the board is full or the side to move is stuck.
+    bool isGameOver(int sideToMove) const;
+    // Player1 minus Player2 at the end of the game; a stuck side's opponent takes the empty cells.
+    int finalMargin(int sideToMove) const;
+
+    uint64_t computeKey() const;
+};
+
+static_assert(sizeof(Bitboard) > 16 || sizeof(Position) == 64);
+
+// The standard 9x9 layout in the grid's top-left corner, Player1 to move; every new game
+// starts from it unless a layout file says otherwise.
+Position startingPosition();
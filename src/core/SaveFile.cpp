@@ -0,0 +1,88 @@
+#include "SaveFile.h"
+
+#include <algorithm>
+#include <cstdlib>
+#include <fstream>
+#include <stdexcept>
+
+std::vector<int> serialize(const SavedGame& game) {
+    std::vector<int> values;
+    values.reserve(2 + BoardGeometry::cellCount);
+
+    values.push_back(game.singleGame ? 1 + static_cast<int>(game.aiKind) : 0);
+    values.push_back(static_cast<int>(game.isPlayer1Turn));
+
+    for (int cell = 0; cell < BoardGeometry::cellCount; cell++) {
+        values.push_back(static_cast<int>(game.position.getState(cell)));
+    }
+    return values;
+}
+
+std::optional<SavedGame> deserialize(const std::vector<int>& values) {
+    if (values.size() != 2 + BoardGeometry::cellCount) {
+        return std::nullopt;
+    }
+
+    SavedGame game;
+    game.singleGame = values[0] != 0;
+    game.aiKind = values[0] == 2 ? AiKind::Mcts : AiKind::Minimax;
+    game.isPlayer1Turn = static_cast<bool>(values[1]);
+
+    for (int cell = 0; cell < BoardGeometry::cellCount; cell++) {
+        int state = values[2 + cell];
+        if (state < 0 || state > static_cast<int>(CellState::Blocked)) {
+            return std::nullopt;
+        }
+        game.position.setState(cell, static_cast<CellState>(state));
+    }
+    return game;
+}
+
+void writeSaveFile(const SavedGame& game, const std::string& filename) {
+    std::ofstream file(filename);
+    if (!file.is_open()) {
+        throw std::runtime_error("Unable to open file for saving.");
+    }
+
+    for (const int value : serialize(game)) {
+        file << value << '\n';
+    }
+}
+
+std::optional<SavedGame> readSaveFile(const std::string& filename) {
+    std::ifstream file(filename);
+    if (!file.is_open()) {
+        return std::nullopt;
+    }
+
+    std::vector<int> values;
+    for (int value; file >> value;) {
+        values.push_back(value);
+    }
+    return deserialize(values);
+}
+
+std::optional<Move> parseRecordedMove(const Position& position, int side, const std::string& token) {
+    auto dash = token.find('-');
+    if (dash == std::string::npos) {
+        return std::nullopt;
+    }
+    int from = std::atoi(token.substr(0, dash).c_str());
+    int to = std::atoi(token.substr(dash + 1).c_str());
+    if (from < 0 || from >= BoardGeometry::cellCount || to < 0 || to >= BoardGeometry::cellCount
+        || !(position.pieces[side] & cellBit(from))) {
+        return std::nullopt;
+    }
+
+    // clones come from one canonical neighbour, so they match on the target alone
+    bool clone = (Topology::of(to).neighborMask & cellBit(from)) != 0;
+    MoveList legal;
+    position.generateMoves(side, legal);
+    auto found = std::find_if(legal.begin(), legal.end(), [&](const Move& move) {
+        return move.to == to && (clone ? move.type == MoveType::Clone : move.from == from);
+    });
+    if (found == legal.end()) {
+        return std::nullopt;
+    }
+    return *found;
+}
@@ -0,0 +1,32 @@
+#pragma once
+
+#include <optional>
+#include <string>
+#include <vector>
+
+#include "AsyncSearch.h"
+#include "Position.h"
+
+// A saved game: the mode, whose turn it is and every cell, one number per line.
+struct SavedGame {
+    Position position;
+    bool isPlayer1Turn = true;
+    bool singleGame = false;
+    AiKind aiKind = AiKind::Minimax;
+};
+
+inline const std::string defaultSaveFile = "board_save.sv";
+
+// 0 - two players, 1 - against the alpha-beta AI, 2 - against MCTS; then the turn and every cell state of the grid
+std::vector<int> serialize(const SavedGame& game);
+std::optional<SavedGame> deserialize(const std::vector<int>& values);
+
+// Throws std::runtime_error when the file cannot be written.
+void writeSaveFile(const SavedGame& game, const std::string& filename = defaultSaveFile);
+// nullopt when the file is missing or malformed
+std::optional<SavedGame> readSaveFile(const std::string& filename = defaultSaveFile);
+
+// A move of a saved game record, "from-to" by cell index, the way hexagon-arena writes them.
+// The record does not say which kind of move it was, the distance does; nullopt when the
+// token is malformed or the move is not legal for side.
+std::optional<Move> parseRecordedMove(const Position& position, int side, const std::string& token);
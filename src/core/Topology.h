@@ -0,0 +1,203 @@
+#pragma once
+
+#include <array>
+#include <bit>
+#include <cstdint>
+#include <type_traits>
+
+// The board size is fixed at build time (CMake option HEXAGON_BOARD_SIZE, default 9) so every
+// mask is a fixed-width integer; layouts smaller than the grid block the cells they leave out.
+#ifndef HEXAGON_BOARD_SIZE
+#define HEXAGON_BOARD_SIZE 9
+#endif
+
+namespace BoardGeometry {
+    constexpr int rows = HEXAGON_BOARD_SIZE;
+    constexpr int cols = HEXAGON_BOARD_SIZE;
+    constexpr int cellCount = rows * cols;
+
+    // the standard layout must fit, and cells are stored in a byte
+    static_assert(rows >= 9 && cellCount < 256, "HEXAGON_BOARD_SIZE must be between 9 and 15");
+}
+
+// Bitboard for grids over 128 cells: little-endian 64-bit words with the handful of integer
+// operations the move generator uses. Shifts are by less than the width.
+template <int Words>
+struct WideBitboard {
+    uint64_t words[Words] = {};
+
+    constexpr WideBitboard() = default;
+    constexpr WideBitboard(uint64_t low) : words{low} {}
+
+    constexpr explicit operator bool() const {
+        for (uint64_t word : words) {
+            if (word) return true;
+        }
+        return false;
+    }
+    constexpr explicit operator uint64_t() const { return words[0]; }
+
+    constexpr bool operator==(const WideBitboard&) const = default;
+
+    constexpr WideBitboard operator~() const {
+        WideBitboard result;
+        for (int i = 0; i < Words; i++) result.words[i] = ~words[i];
+        return result;
+    }
+
+    constexpr WideBitboard& operator&=(const WideBitboard& other) {
+        for (int i = 0; i < Words; i++) words[i] &= other.words[i];
+        return *this;
+    }
+    constexpr WideBitboard& operator|=(const WideBitboard& other) {
+        for (int i = 0; i < Words; i++) words[i] |= other.words[i];
+        return *this;
+    }
+    constexpr WideBitboard& operator^=(const WideBitboard& other) {
+        for (int i = 0; i < Words; i++) words[i] ^= other.words[i];
+        return *this;
+    }
+
+    constexpr WideBitboard operator<<(int shift) const {
+        WideBitboard result;
+        int step = shift / 64;
+        int bits = shift % 64;
+        for (int i = Words - 1; i >= step; i--) {
+            result.words[i] = words[i - step] << bits;
+            if (bits && i - step > 0) result.words[i] |= words[i - step - 1] >> (64 - bits);
+        }
+        return result;
+    }
+    constexpr WideBitboard operator>>(int shift) const {
+        WideBitboard result;
+        int step = shift / 64;
+        int bits = shift % 64;
+        for (int i = 0; i + step < Words; i++) {
+            result.words[i] = words[i + step] >> bits;
+            if (bits && i + step + 1 < Words) result.words[i] |= words[i + step + 1] << (64 - bits);
+        }
+        return result;
+    }
+
+    constexpr WideBitboard operator+(const WideBitboard& other) const {
+        WideBitboard result;
+        uint64_t carry = 0;
+        for (int i = 0; i < Words; i++) {
+            uint64_t sum = words[i] + other.words[i];
+            uint64_t next = sum < words[i];
+            result.words[i] = sum + carry;
+            carry = next | (result.words[i] < sum);
+        }
+        return result;
+    }
+    constexpr WideBitboard operator-(const WideBitboard& other) const { return *this + (~other + WideBitboard(1)); }
+
+    friend constexpr WideBitboard operator&(WideBitboard a, const WideBitboard& b) { return a &= b; }
+    friend constexpr WideBitboard operator|(WideBitboard a, const WideBitboard& b) { return a |= b; }
+    friend constexpr WideBitboard operator^(WideBitboard a, const WideBitboard& b) { return a ^= b; }
+};
+
+// One bit per cell, row-major: bit = row * cols + col. Boards up to 11x11 fit a 128-bit integer.
+using Bitboard = std::conditional_t<BoardGeometry::cellCount <= 128, unsigned __int128,
+                                    WideBitboard<(BoardGeometry::cellCount + 63) / 64>>;
+constexpr int bitboardWords = sizeof(Bitboard) / sizeof(uint64_t);
+
+constexpr int cellIndex(int row, int col) { return row * BoardGeometry::cols + col; }
+constexpr int cellRow(int cell) { return cell / BoardGeometry::cols; }
+constexpr int cellCol(int cell) { return cell % BoardGeometry::cols; }
+constexpr Bitboard cellBit(int cell) { return Bitboard(1) << cell; }
+
+// The 64-bit word of bb holding bits 64 * index and up.
+constexpr uint64_t bitboardWord(unsigned __int128 bb, int index) {
+    return static_cast<uint64_t>(bb >> (64 * index));
+}
+
+template <int Words>
+constexpr uint64_t bitboardWord(const WideBitboard<Words>& bb, int index) {
+    return bb.words[index];
+}
+
+inline int popcount(Bitboard bb) {
+    int count = 0;
+    for (int i = 0; i < bitboardWords; i++) {
+        count += std::popcount(bitboardWord(bb, i));
+    }
+    return count;
+}
+
+// Index of the lowest set bit; bb must not be empty.
+inline int lsb(Bitboard bb) {
+    for (int i = 0; i < bitboardWords - 1; i++) {
+        uint64_t word = bitboardWord(bb, i);
+        if (word) return 64 * i + std::countr_zero(word);
+    }
+    return 64 * (bitboardWords - 1) + std::countr_zero(bitboardWord(bb, bitboardWords - 1));
+}
+
+inline int popLsb(Bitboard& bb) {
+    int cell = lsb(bb);
+    bb &= bb - 1;
+    return cell;
+}
+
+// Ring-1 (clone) and ring-2 (jump) cells around every cell, built at compile time.
+// Odd columns sit half a cell lower, so the offsets depend on the column parity.
+struct CellTopology {
+    uint8_t neighbors[6] = {};
+    uint8_t jumps[12] = {};
+    uint8_t neighborCount = 0;
+    uint8_t jumpCount = 0;
+    Bitboard neighborMask = 0;
+    Bitboard jumpMask = 0;
+};
+
+namespace Topology {
+    struct Offset { int row, col; };
+
+    // indexed by column parity
+    constexpr Offset ring1[2][6] = {
+        {{-1, 0}, {1, 0}, {0, -1}, {0, 1}, {-1, -1}, {-1, 1}},
+        {{-1, 0}, {1, 0}, {0, -1}, {0, 1}, {1, -1}, {1, 1}},
+    };
+    constexpr Offset ring2[2][12] = {
+        {{-2, 0}, {2, 0}, {-2, -1}, {1, -1}, {-2, 1}, {1, 1},
+         {-1, -2}, {0, -2}, {1, -2}, {-1, 2}, {0, 2}, {1, 2}},
+        {{-2, 0}, {2, 0}, {-1, -1}, {2, -1}, {-1, 1}, {2, 1},
+         {-1, -2}, {0, -2}, {1, -2}, {-1, 2}, {0, 2}, {1, 2}},
+    };
+
+    constexpr bool onBoard(int row, int col) {
+        return row >= 0 && row < BoardGeometry::rows && col >= 0 && col < BoardGeometry::cols;
+    }
+
+    constexpr std::array<CellTopology, BoardGeometry::cellCount> build() {
+        std::array<CellTopology, BoardGeometry::cellCount> table{};
+
+        for (int cell = 0; cell < BoardGeometry::cellCount; cell++) {
+            int row = cellRow(cell);
+            int col = cellCol(cell);
+            CellTopology& entry = table[cell];
+
+            for (const Offset& offset : ring1[col % 2]) {
+                if (onBoard(row + offset.row, col + offset.col)) {
+                    int other = cellIndex(row + offset.row, col + offset.col);
+                    entry.neighbors[entry.neighborCount++] = static_cast<uint8_t>(other);
+                    entry.neighborMask |= cellBit(other);
+                }
+            }
+            for (const Offset& offset : ring2[col % 2]) {
+                if (onBoard(row + offset.row, col + offset.col)) {
+                    int other = cellIndex(row + offset.row, col + offset.col);
+                    entry.jumps[entry.jumpCount++] = static_cast<uint8_t>(other);
+                    entry.jumpMask |= cellBit(other);
+                }
+            }
+        }
+        return table;
+    }
+
+    inline constexpr auto cells = build();
+
+    constexpr const CellTopology& of(int cell) { return cells[cell]; }
+    constexpr const CellTopology& of(int row, int col) { return cells[cellIndex(row, col)]; }
+}
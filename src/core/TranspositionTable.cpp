@@ -0,0 +1,113 @@
+#include "TranspositionTable.h"
+
+namespace {
+    // data layout: score:16 | depth:8 | from:8 | to:8 | type:1 | bound:2 | unused:5 | generation:8 | unused:8
+    uint64_t pack(const TTEntry& entry, uint8_t generation) {
+        return static_cast<uint64_t>(static_cast<uint16_t>(entry.score))
+            | static_cast<uint64_t>(static_cast<uint8_t>(entry.depth)) << 16
+            | static_cast<uint64_t>(entry.move.from) << 24
+            | static_cast<uint64_t>(entry.move.to) << 32
+            | static_cast<uint64_t>(entry.move.type) << 40
+            | static_cast<uint64_t>(entry.bound) << 41
+            | static_cast<uint64_t>(generation) << 48;
+    }
+
+    TTEntry unpack(uint64_t data) {
+        TTEntry entry;
+        entry.score = static_cast<int16_t>(data & 0xFFFF);
+        entry.depth = static_cast<uint8_t>(data >> 16);
+        entry.move.from = static_cast<uint8_t>(data >> 24);
+        entry.move.to = static_cast<uint8_t>(data >> 32);
+        entry.move.type = static_cast<MoveType>((data >> 40) & 1);
+        entry.bound = static_cast<Bound>((data >> 41) & 3);
+        return entry;
+    }
+
+    int depthOf(uint64_t data) { return static_cast<uint8_t>(data >> 16); }
+    Bound boundOf(uint64_t data) { return static_cast<Bound>((data >> 41) & 3); }
+    uint8_t generationOf(uint64_t data) { return static_cast<uint8_t>(data >> 48); }
+}
+
+TranspositionTable::TranspositionTable(int sizeMb) {
+    resize(sizeMb);
+}
+
+void TranspositionTable::resize(int sizeMb) {
+    // round down to a power of two number of buckets, at least one
+    uint64_t count = 1;
+    while (count * 2 * sizeof(Bucket) <= static_cast<uint64_t>(sizeMb) << 20) {
+        count *= 2;
+    }
+
+    buckets = std::make_unique<Bucket[]>(count);
+    bucketCount = count;
+    this->sizeMb = sizeMb;
+    generation = 0;
+}
+
+void TranspositionTable::clear() {
+    for (uint64_t i = 0; i < bucketCount; i++) {
+        for (Slot& slot : buckets[i].slots) {
+            slot.check.store(0, std::memory_order_relaxed);
+            slot.data.store(0, std::memory_order_relaxed);
+        }
+    }
+    generation = 0;
+}
+
+bool TranspositionTable::probe(uint64_t key, TTEntry& entry) const {
+    for (const Slot& slot : bucketFor(key).slots) {
+        uint64_t data = slot.data.load(std::memory_order_relaxed);
+        uint64_t check = slot.check.load(std::memory_order_relaxed);
+
+        if ((check ^ data) == key && boundOf(data) != Bound::None) {
+            entry = unpack(data);
+            return true;
+        }
+    }
+    return false;
+}
+
+bool TranspositionTable::store(uint64_t key, const TTEntry& entry) {
+    Bucket& bucket = bucketFor(key);
+
+    Slot* victim = nullptr;
+    int victimWorth = 0;
+
+    for (Slot& slot : bucket.slots) {
+        uint64_t data = slot.data.load(std::memory_order_relaxed);
+        uint64_t check = slot.check.load(std::memory_order_relaxed);
+
+        if ((check ^ data) == key && boundOf(data) != Bound::None) {
+            // same position: keep a deeper result from this search unless the new one is exact
+            if (entry.bound != Bound::Exact && generationOf(data) == generation && depthOf(data) > entry.depth) {
+                return false;
+            }
+
+            TTEntry stored = entry;
+            if (!stored.move.isValid()) {
+                stored.move = unpack(data).move;
+            }
+            uint64_t packed = pack(stored, generation);
+            slot.data.store(packed, std::memory_order_relaxed);
+            slot.check.store(key ^ packed, std::memory_order_relaxed);
+            return false;
+        }
+
+        // prefer empty slots, then stale ones, then the shallowest
+        int age = (generation - generationOf(data)) & 0xFF;
+        int worth = boundOf(data) == Bound::None ? -1024 : depthOf(data) - 8 * age;
+        if (victim == nullptr || worth < victimWorth) {
+            victim = &slot;
+            victimWorth = worth;
+        }
+    }
+
+    uint64_t old = victim->data.load(std::memory_order_relaxed);
+    bool collision = boundOf(old) != Bound::None && generationOf(old) == generation;
+
+    uint64_t packed = pack(entry, generation);
+    victim->data.store(packed, std::memory_order_relaxed);
+    victim->check.store(key ^ packed, std::memory_order_relaxed);
+    return collision;
+}
@@ -0,0 +1,58 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+
+#include "Position.h"
+
+enum class Bound : uint8_t { None, Upper, Lower, Exact };
+
+struct TTEntry {
+    Move move;
+    int score = 0;
+    int depth = 0;
+    Bound bound = Bound::None;
+};
+
+// Fixed-size hash table of search results, bucketed by cache line.
+// Entries are stored as (key ^ data, data) pairs of relaxed atomics, so threads can share
+// the table without locks: a torn write fails the key check and reads as a miss.
+class TranspositionTable {
+public:
+    static constexpr int defaultSizeMb = 16;
+
+    explicit TranspositionTable(int sizeMb = defaultSizeMb);
+
+    void resize(int sizeMb);
+    void clear();
+    int getSizeMb() const { return sizeMb; }
+
+    // Ages out entries of previous searches for replacement.
+    void newSearch() { generation = (generation + 1) & 0xFF; }
+
+    bool probe(uint64_t key, TTEntry& entry) const;
+    // Returns true when the entry evicted a different position stored during this search.
+    bool store(uint64_t key, const TTEntry& entry);
+
+private:
+    struct Slot {
+        std::atomic<uint64_t> check{0};
+        std::atomic<uint64_t> data{0};
+    };
+
+    static constexpr int slotsPerBucket = 4;
+
+    struct alignas(64) Bucket {
+        Slot slots[slotsPerBucket];
+    };
+
+    static_assert(sizeof(Bucket) == 64);
+
+    Bucket& bucketFor(uint64_t key) const { return buckets[key & (bucketCount - 1)]; }
+
+    std::unique_ptr<Bucket[]> buckets;
+    uint64_t bucketCount = 0;
+    int sizeMb = 0;
+    uint8_t generation = 0;
+};
@@ -0,0 +1,492 @@
+#include "ai.h"
+#include <algorithm>
+#include <cstdlib>
+
+namespace {
+    // static scores stay clear of the won and lost range
+    constexpr int maxEvalScore = winScore - maxSearchDepth - 1;
+
+    bool isDecided(int score) {
+        return std::abs(score) > winScore - maxSearchDepth;
+    }
+
+    // won and lost scores are stored relative to the node, not the root
+    int scoreToHash(int score, int ply) {
+        if (score > winScore - maxSearchDepth) return score + ply;
+        if (score < -winScore + maxSearchDepth) return score - ply;
+        return score;
+    }
+
+    int scoreFromHash(int score, int ply) {
+        if (score > winScore - maxSearchDepth) return score - ply;
+        if (score < -winScore + maxSearchDepth) return score + ply;
+        return score;
+    }
+
+    // Lazy SMP helpers skip alternating iterations in staggered phases so threads spread over depths.
+    constexpr int skipSize[] = {1, 1, 2, 2, 2, 2, 3, 3, 3, 3, 3, 3, 4, 4, 4, 4, 4, 4, 4, 4};
+    constexpr int skipPhase[] = {0, 1, 0, 1, 2, 3, 0, 1, 2, 3, 4, 5, 0, 1, 2, 3, 4, 5, 6, 7};
+
+    bool skipDepth(int id, int depth) {
+        if (id == 0) return false;
+        int slot = (id - 1) % 20;
+        return ((depth + skipPhase[slot]) / skipSize[slot]) % 2 != 0;
+    }
+
+    // Every clone into a cell gives the same position, whichever piece it came from.
+    bool sameMove(const Move& a, const Move& b) {
+        return a.to == b.to && a.type == b.type && (a.type == MoveType::Clone || a.from == b.from);
+    }
+
+    // Ordering keys after the hash/PV move, highest first: capture gain, clones before jumps,
+    // killers, history counters.
+    constexpr int captureOrder = 1 << 26;
+    constexpr int cloneOrder = 1 << 25;
+    constexpr int killerOrder = 1 << 23;
+    constexpr int historyLimit = killerOrder - 1;
+
+    void pickMove(MoveList& moves, int* order, int index) {
+        int best = index;
+        for (int i = index + 1; i < moves.size; i++) {
+            if (order[i] > order[best]) best = i;
+        }
+        std::swap(moves.moves[index], moves.moves[best]);
+        std::swap(order[index], order[best]);
+    }
+}
+
+SearchStats& SearchStats::operator+=(const SearchStats& other) {
+    ttProbes += other.ttProbes;
+    ttHits += other.ttHits;
+    ttCollisions += other.ttCollisions;
+    cutNodes += other.cutNodes;
+    firstMoveCutoffs += other.firstMoveCutoffs;
+    return *this;
+}
+
+// Per-thread search state; the engine owns one per thread and they share only its table.
+class SearchWorker {
+public:
+    SearchWorker(Engine& engine, int id) : engine(engine), id(id) {};
+
+    void iterate();
+
+    int completedDepth = 0;
+    int score = 0;
+    std::vector<Move> pv;
+    uint64_t nodes = 0;
+    SearchStats stats;
+
+private:
+    int negamax(int side, int depth, int ply, int alpha, int beta);
+    void orderMoves(const MoveList& moves, int from, int side, int ply, int* order) const;
+    void updateCutoffHeuristics(const Move& move, int side, int depth, int ply);
+    int& history(int side, const Move& move) {
+        return historyTable[side][move.type == MoveType::Clone ? move.to : move.from][move.to];
+    }
+    bool timeIsUp();
+    void extendPvFromHash(std::vector<Move>& pv, int depth) const;
+
+    Engine& engine;
+    int id;
+
+    // searched in place with makeMove/unmakeMove, one undo record per ply
+    Position position;
+    Undo undoStack[maxSearchDepth];
+    // first-layer sums of the network at every ply, when the engine has one
+    const NnueNetwork* network = nullptr;
+    NnueAccumulator accumulators[maxSearchDepth];
+
+    Move pvTable[maxSearchDepth][maxSearchDepth];
+    int pvLength[maxSearchDepth];
+
+    // principal variation of the previous iteration, searched first
+    std::vector<Move> previousPv;
+    bool followPv = false;
+
+    // quiet-move ordering: two killers per ply, butterfly history per side (clones indexed by target)
+    Move killers[maxSearchDepth][2];
+    int historyTable[2][BoardGeometry::cellCount][BoardGeometry::cellCount] = {};
+};
+
+Engine::Engine(int hashSizeMb, int threads) : tt(std::max(hashSizeMb, 1)) {
+    hashEnabled = hashSizeMb > 0;
+    setThreads(threads);
+}
+
+Engine::~Engine() {
+    stopHelpers();
+}
+
+void Engine::setHashSize(int sizeMb) {
+    hashEnabled = sizeMb > 0;
+    if (hashEnabled && sizeMb != tt.getSizeMb()) {
+        tt.resize(sizeMb);
+    }
+}
+
+void Engine::setThreads(int count) {
+    count = std::max(count, 1);
+    if (count == getThreads()) return;
+
+    stopHelpers();
+
+    workers.clear();
+    for (int id = 0; id < count; id++) {
+        workers.push_back(std::make_unique<SearchWorker>(*this, id));
+    }
+
+    quit = false;
+    for (int id = 1; id < count; id++) {
+        helpers.emplace_back(&Engine::helperLoop, this, id);
+    }
+}
+
+void Engine::stopHelpers() {
+    {
+        std::lock_guard<std::mutex> lock(poolMutex);
+        quit = true;
+    }
+    startSignal.notify_all();
+
+    for (auto& helper : helpers) {
+        helper.join();
+    }
+    helpers.clear();
+}
+
+void Engine::helperLoop(int id) {
+    uint64_t lastSearch = 0;
+
+    while (true) {
+        {
+            std::unique_lock<std::mutex> lock(poolMutex);
+            startSignal.wait(lock, [&] { return quit || searchId != lastSearch; });
+            if (quit) return;
+            lastSearch = searchId;
+        }
+
+        workers[id]->iterate();
+
+        {
+            std::lock_guard<std::mutex> lock(poolMutex);
+            runningHelpers--;
+        }
+        doneSignal.notify_all();
+    }
+}
+
+SearchResult Engine::search(const Position& position, CellState player, const SearchLimits& limits) {
+    if (book) {
+        if (auto entry = book->probe(position, Position::side(player), position.key ^ bookProbes++)) {
+            SearchResult result;
+            result.bestMove = entry->move();
+            result.score = entry->score;
+            result.pv = {result.bestMove};
+            result.fromBook = true;
+            return result;
+        }
+    }
+
+    rootPosition = position;
+    rootSide = Position::side(player);
+    this->limits = limits;
+    startTime = std::chrono::steady_clock::now();
+    stopped = false;
+
+    // Only a proof ends the search. Nearly every solve meets a jump line it can only
+    // adjudicate, so the solver gives up there instead of spending the time on a guess.
+    if (limits.timeMs > 0 && popcount(position.empty()) <= solverThreshold) {
+        if (!solver) solver = std::make_unique<EndgameSolver>();
+        SolveResult solved = solver->solve(position, rootSide, SolveMode::Exact, {limits.timeMs / 2, limits.stopSignal, true});
+        if (solved.complete && !solved.adjudicated && solved.bestMove.isValid()) {
+            SearchResult result;
+            result.bestMove = solved.bestMove;
+            result.score = solved.margin * pieceScore;
+            result.pv = {result.bestMove};
+            result.nodes = solved.nodes;
+            result.timeMs = solved.timeMs;
+            result.solved = true;
+            return result;
+        }
+    }
+
+    tt.newSearch();
+
+    {
+        std::lock_guard<std::mutex> lock(poolMutex);
+        searchId++;
+        runningHelpers = static_cast<int>(helpers.size());
+    }
+    startSignal.notify_all();
+
+    workers[0]->iterate();
+    stopped = true;
+
+    {
+        std::unique_lock<std::mutex> lock(poolMutex);
+        doneSignal.wait(lock, [&] { return runningHelpers == 0; });
+    }
+
+    // the main thread's answer unless a helper finished a deeper iteration
+    SearchWorker* best = workers[0].get();
+    for (auto& worker : workers) {
+        if (worker->completedDepth > best->completedDepth && !worker->pv.empty()) {
+            best = worker.get();
+        }
+    }
+
+    SearchResult result;
+    result.score = best->score;
+    result.depth = best->completedDepth;
+    result.pv = best->pv;
+    result.bestMove = result.pv.empty() ? Move() : result.pv.front();
+
+    for (auto& worker : workers) {
+        result.nodes += worker->nodes;
+        result.stats += worker->stats;
+        result.threadNodes.push_back(worker->nodes);
+    }
+
+    result.timeMs = static_cast<int>(std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::steady_clock::now() - startTime).count());
+    return result;
+}
+
+void SearchWorker::iterate() {
+    position = engine.rootPosition;
+    network = engine.network.get();
+    if (network) {
+        network->refresh(position, accumulators[0]);
+    }
+    completedDepth = 0;
+    score = 0;
+    pv.clear();
+    nodes = 0;
+    stats = SearchStats();
+    previousPv.clear();
+
+    for (auto& plyKillers : killers) {
+        plyKillers[0] = plyKillers[1] = Move();
+    }
+    // keep what earlier searches learned, but let this one outweigh it
+    for (auto& sideHistory : historyTable) {
+        for (auto& fromHistory : sideHistory) {
+            for (int& value : fromHistory) {
+                value /= 2;
+            }
+        }
+    }
+
+    int side = engine.rootSide;
+    int maxDepth = std::min(engine.limits.depth, maxSearchDepth - 1);
+
+    for (int depth = 1; depth <= maxDepth; depth++) {
+        if (skipDepth(id, depth) && depth < maxDepth) continue;
+
+        followPv = true;
+        int iterationScore = negamax(side, depth, 0, -winScore - 1, winScore + 1);
+        // only the main thread keeps an unfinished first iteration, so there is always a move;
+        // a helper's would outrank the main thread's finished shallower one
+        if (engine.stopped && (completedDepth > 0 || id != 0)) break;
+
+        score = iterationScore;
+        completedDepth = depth;
+        pv.assign(pvTable[0], pvTable[0] + pvLength[0]);
+        extendPvFromHash(pv, depth);
+        previousPv = pv;
+
+        // a decided game does not get any clearer deeper down
+        if (engine.stopped || isDecided(score)) break;
+    }
+}
+
+// Cutoffs on hash hits leave the PV short; finish it from the table while the moves stay legal.
+void SearchWorker::extendPvFromHash(std::vector<Move>& pv, int depth) const {
+    if (!engine.hashEnabled) return;
+
+    Position current = engine.rootPosition;
+    int side = engine.rootSide;
+    for (const Move& move : pv) {
+        current.play(move);
+        side ^= 1;
+    }
+
+    TTEntry entry;
+    while (static_cast<int>(pv.size()) < depth && !current.isGameOver(side)
+           && engine.tt.probe(current.key ^ Zobrist::sideKey(side), entry) && entry.move.isValid()) {
+        MoveList moves;
+        current.generateMoves(side, moves);
+        if (std::find(moves.begin(), moves.end(), entry.move) == moves.end()) break;
+
+        pv.push_back(entry.move);
+        current.play(entry.move);
+        side ^= 1;
+    }
+}
+
+void SearchWorker::orderMoves(const MoveList& moves, int from, int side, int ply, int* order) const {
+    NeighborCounts captures = neighborCounts(position.pieces[side ^ 1]);
+
+    for (int i = from; i < moves.size; i++) {
+        const Move& move = moves.moves[i];
+
+        int key = captures.at(move.to) * captureOrder;
+        if (move.type == MoveType::Clone) key += cloneOrder;
+
+        if (sameMove(move, killers[ply][0])) {
+            key += 2 * killerOrder;
+        } else if (sameMove(move, killers[ply][1])) {
+            key += killerOrder;
+        } else {
+            key += historyTable[side][move.type == MoveType::Clone ? move.to : move.from][move.to];
+        }
+        order[i] = key;
+    }
+}
+
+void SearchWorker::updateCutoffHeuristics(const Move& move, int side, int depth, int ply) {
+    if (!sameMove(move, killers[ply][0])) {
+        killers[ply][1] = killers[ply][0];
+        killers[ply][0] = move;
+    }
+
+    int& value = history(side, move);
+    value = std::min(value + depth * depth, historyLimit);
+}
+
+bool SearchWorker::timeIsUp() {
+    if (engine.limits.stopSignal && engine.limits.stopSignal->load(std::memory_order_relaxed)) {
+        engine.stopped = true;
+    }
+    if (engine.limits.timeMs > 0 && (nodes & 2047) == 0) {
+        auto elapsed = std::chrono::steady_clock::now() - engine.startTime;
+        if (elapsed >= std::chrono::milliseconds(engine.limits.timeMs)) {
+            engine.stopped = true;
+        }
+    }
+    return engine.stopped;
+}
+
+int SearchWorker::negamax(int side, int depth, int ply, int alpha, int beta) {
+    nodes++;
+    pvLength[ply] = 0;
+
+    if (position.isGameOver(side)) {
+        int margin = position.finalMargin(side);
+        if (side == 1) margin = -margin;
+
+        if (margin > 0) return winScore - ply;
+        if (margin < 0) return -winScore + ply;
+        return 0;
+    }
+
+    if (depth == 0 || ply >= maxSearchDepth - 1) {
+        int score = network ? network->evaluate(accumulators[ply], side) : evaluate(position, side, engine.weights);
+        return std::clamp(score, -maxEvalScore, maxEvalScore);
+    }
+
+    uint64_t key = position.key ^ Zobrist::sideKey(side);
+    Move hashMove;
+
+    if (engine.hashEnabled) {
+        TTEntry entry;
+        stats.ttProbes++;
+        if (engine.tt.probe(key, entry)) {
+            stats.ttHits++;
+            hashMove = entry.move;
+
+            if (ply > 0 && entry.depth >= depth) {
+                int score = scoreFromHash(entry.score, ply);
+                if (entry.bound == Bound::Exact
+                    || (entry.bound == Bound::Lower && score >= beta)
+                    || (entry.bound == Bound::Upper && score <= alpha)) {
+                    return score;
+                }
+            }
+        }
+    }
+
+    MoveList moves;
+    position.generateMoves(side, moves);
+
+    bool pvNode = followPv && ply < static_cast<int>(previousPv.size());
+    followPv = false;
+    Move firstMove = pvNode ? previousPv[ply] : hashMove;
+
+    // the hash/PV move is tried before the rest are scored, it usually cuts off alone
+    int ordered = 0;
+    if (firstMove.isValid()) {
+        auto found = std::find(moves.begin(), moves.end(), firstMove);
+        if (found != moves.end()) {
+            std::swap(*found, moves.moves[0]);
+            ordered = 1;
+        }
+    }
+    if (ordered == 0) {
+        pvNode = false;
+    }
+
+    int order[maxMoves];
+    int alphaOrig = alpha;
+    int bestScore = -winScore - 1;
+    Move bestMove;
+
+    for (int i = 0; i < moves.size; i++) {
+        if (i == ordered) {
+            orderMoves(moves, ordered, side, ply, order);
+        }
+        if (i >= ordered) {
+            pickMove(moves, order, i);
+        }
+        const Move& move = moves.moves[i];
+        position.makeMove(side, move, undoStack[ply]);
+        if (network) {
+            network->update(accumulators[ply], accumulators[ply + 1], side, undoStack[ply]);
+        }
+
+        followPv = pvNode && i == 0;
+        int score = -negamax(side ^ 1, depth - 1, ply + 1, -beta, -alpha);
+        followPv = false;
+
+        position.unmakeMove(side, undoStack[ply]);
+        if (timeIsUp()) return 0;
+
+        if (score > bestScore) {
+            bestScore = score;
+            bestMove = move;
+
+            if (score > alpha) {
+                alpha = score;
+
+                pvTable[ply][0] = move;
+                for (int j = 0; j < pvLength[ply + 1]; j++) {
+                    pvTable[ply][j + 1] = pvTable[ply + 1][j];
+                }
+                pvLength[ply] = pvLength[ply + 1] + 1;
+
+                if (alpha >= beta) {
+                    stats.cutNodes++;
+                    if (i == 0) stats.firstMoveCutoffs++;
+                    updateCutoffHeuristics(move, side, depth, ply);
+                    break;
+                }
+            }
+        }
+    }
+
+    if (engine.hashEnabled) {
+        Bound bound = bestScore >= beta ? Bound::Lower : bestScore > alphaOrig ? Bound::Exact : Bound::Upper;
+        if (engine.tt.store(key, {bestMove, scoreToHash(bestScore, ply), depth, bound})) {
+            stats.ttCollisions++;
+        }
+    }
+
+    return bestScore;
+}
+
+Move getBestMove(const BoardState& board, CellState player, const SearchLimits& limits) {
+    // one engine per calling thread, so its table is allocated once and carries over between moves
+    thread_local Engine engine;
+    return engine.search(board.position, player, limits).bestMove;
+}
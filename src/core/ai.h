@@ -0,0 +1,134 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "BoardState.h"
+#include "EndgameSolver.h"
+#include "Evaluation.h"
+#include "Nnue.h"
+#include "OpeningBook.h"
+#include "TranspositionTable.h"
+
+constexpr int maxSearchDepth = 64;
+
+// Scores are from the side to move's point of view in hundredths of a piece; won games score
+// above winScore - maxSearchDepth.
+constexpr int winScore = 10000;
+
+struct SearchLimits {
+    int depth = maxSearchDepth;
+    int timeMs = 0;  // 0 - no time limit
+    // raised by another thread to abort the search; may be set before the search starts
+    const std::atomic<bool>* stopSignal = nullptr;
+};
+
+struct SearchStats {
+    uint64_t ttProbes = 0;
+    uint64_t ttHits = 0;
+    uint64_t ttCollisions = 0;
+    // beta cutoffs, and how many of them came from the first move searched
+    uint64_t cutNodes = 0;
+    uint64_t firstMoveCutoffs = 0;
+
+    double ttHitRate() const { return ttProbes ? static_cast<double>(ttHits) / ttProbes : 0.0; }
+    double firstMoveCutoffRate() const { return cutNodes ? static_cast<double>(firstMoveCutoffs) / cutNodes : 0.0; }
+
+    SearchStats& operator+=(const SearchStats& other);
+};
+
+struct SearchResult {
+    Move bestMove;
+    // In hundredths of a piece for the side to move, whoever answered: the search, the
+    // solver (the final margin), the book, or MCTS (its win rate through expectedResult).
+    int score = 0;
+    int depth = 0;
+    std::vector<Move> pv;
+    uint64_t nodes = 0;
+    int timeMs = 0;
+    SearchStats stats;
+    // nodes searched by each thread, the calling thread first
+    std::vector<uint64_t> threadNodes;
+    // played straight from the opening book without searching
+    bool fromBook = false;
+    // solved to the end of the game; score is then the final margin
+    bool solved = false;
+
+    double nodesPerSecond(uint64_t count) const { return timeMs ? count * 1000.0 / timeMs : 0.0; }
+};
+
+class SearchWorker;
+
+// Negamax alpha-beta search with iterative deepening for either side.
+// With more than one thread it runs Lazy SMP: persistent helper threads search the same
+// root at staggered depths and share work only through the transposition table.
+class Engine {
+public:
+    explicit Engine(int hashSizeMb = TranspositionTable::defaultSizeMb, int threads = 1);
+    ~Engine();
+
+    Engine(const Engine&) = delete;
+    Engine& operator=(const Engine&) = delete;
+
+    // 0 disables the transposition table
+    void setHashSize(int sizeMb);
+    void clearHash() { tt.clear(); }
+
+    void setThreads(int count);
+    int getThreads() const { return static_cast<int>(workers.size()); }
+
+    // Positions found in the book are answered from it; nullptr turns the book off.
+    void setOpeningBook(std::shared_ptr<const OpeningBook> book) { this->book = std::move(book); }
+
+    void setEvalWeights(const EvalWeights& weights) { this->weights = weights; }
+    // Evaluates with the network instead of the weighted terms; nullptr switches back.
+    void setNetwork(std::shared_ptr<const NnueNetwork> network) { this->network = std::move(network); }
+
+    // Timed searches with at most this many empty cells first try the endgame solver for
+    // half of the time. Only a proof ends the search: the solver stops at the first line it
+    // would have to adjudicate. 0 turns the solver off.
+    void setSolverThreshold(int emptyCells) { solverThreshold = emptyCells; }
+
+    SearchResult search(const Position& position, CellState player, const SearchLimits& limits);
+    void stop() { stopped = true; }
+
+private:
+    friend class SearchWorker;
+
+    void helperLoop(int id);
+    void stopHelpers();
+
+    Position rootPosition;
+    int rootSide = 0;
+    SearchLimits limits;
+    std::chrono::steady_clock::time_point startTime;
+    std::atomic<bool> stopped = false;
+
+    TranspositionTable tt;
+    bool hashEnabled = true;
+    EvalWeights weights;
+    std::shared_ptr<const NnueNetwork> network;
+    std::shared_ptr<const OpeningBook> book;
+    uint64_t bookProbes = 0;
+    // created on the first solve
+    std::unique_ptr<EndgameSolver> solver;
+    int solverThreshold = EndgameSolver::defaultEmptyThreshold;
+
+    std::vector<std::unique_ptr<SearchWorker>> workers;
+    std::vector<std::thread> helpers;
+    std::mutex poolMutex;
+    std::condition_variable startSignal;
+    std::condition_variable doneSignal;
+    uint64_t searchId = 0;
+    int runningHelpers = 0;
+    bool quit = false;
+};
+
+// Searches with an engine kept for the calling thread; its table persists between calls.
+Move getBestMove(const BoardState& board, CellState player, const SearchLimits& limits);
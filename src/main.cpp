@@ -2,6 +2,7 @@
 #include <iostream>
 #include "Menu.h"
 #include "Game.h"
+#include "Tween.h"
 
 
 int main() {
@@ -23,12 +24,14 @@ int main() {
     // Создание кнопок
     std::vector<sf::Color> colors = {
         Palette::Sky,
+        Palette::Mauve,
         Palette::Green,
         Palette::Yellow,
         Palette::Red
     };
     std::vector<std::string> labels = {
         " Player\n   vs\nComputer",
+        "Player\n  vs\n MCTS",
         "Player\n  vs\nPlayer",
         "Load\nGame",
         "Exit"
@@ -47,7 +50,7 @@ int main() {
             startMenu.handleEvent(*event);
         }
 
-        startMenu.update(dt);
+        tweens().advance(dt);
 
         startMenu.draw();
 
@@ -57,14 +60,17 @@ int main() {
             if (selected == 0) {
                 game = std::make_unique<Game>(window, true, font);
                 game->run(false);
-            } else if (selected == 1 ) {
-                game = std::make_unique<Game>(window, false, font);
+            } else if (selected == 1) {
+                game = std::make_unique<Game>(window, true, font, AiKind::Mcts);
                 game->run(false);
             } else if (selected == 2) {
+                game = std::make_unique<Game>(window, false, font);
+                game->run(false);
+            } else if (selected == 3) {
                 game = std::make_unique<Game>(window, false, font);
                 game->run(true);
             }
-             else if (selected == 3) {
+             else if (selected == 4) {
                 window.close();
             }
         }
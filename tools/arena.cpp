@@ -0,0 +1,500 @@
+// hexagon-arena: plays engine-vs-engine matches on a pool of worker threads.
+//
+//   hexagon-arena --engine1 "minimax,movetime=50" --engine2 "mcts,movetime=50" [options]
+//
+// Engine specs are a kind (minimax or mcts) followed by comma separated settings:
+//   depth=N  movetime=ms  tc=base+increment (ms)  hash=mb (default 16, 0 turns it off)  threads=N
+//   book=file  opening book to play from while it has moves
+//   eval=file  evaluation weights written by hexagon-tune   (minimax only)
+//   nnue=file  evaluation network                           (minimax only)
+//   iterations=N  policy=greedy|random  c=exploration  nodes=N   (mcts only)
+// Options:
+//   --games N          games to play, in pairs with colours swapped (default 200)
+//   --concurrency N    games played at once (default: every core)
+//   --layout file      starting layout (default: the standard board)
+//   --random-plies N   random moves from the starting layout to open each pair (default 4)
+//   --openings file    one opening per line as from-to cell indices, e.g. "18-19 4-13"
+//   --sprt elo0 elo1   stop as soon as the test accepts either hypothesis
+//   --alpha a --beta b error rates for the test (default 0.05 each)
+//   --max-plies N      longer games are decided by piece count (default 400)
+//   --save-games file  append every game as its result for Player1 and from-to moves, for hexagon-book
+//   --seed N
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "AsyncSearch.h"
+#include "Layout.h"
+#include "OpeningBook.h"
+#include "SaveFile.h"
+
+namespace {
+    struct EngineConfig {
+        std::string spec;
+        AiKind kind = AiKind::Minimax;
+        int depth = maxSearchDepth;
+        int moveTimeMs = 0;
+        int baseMs = 0;
+        int incrementMs = 0;
+        int hashMb = TranspositionTable::defaultSizeMb;
+        int threads = 1;
+        int iterations = 0;
+        PlayoutPolicy policy = PlayoutPolicy::Greedy;
+        double exploration = 1.0;
+        int mctsNodes = 1 << 18;
+        std::shared_ptr<const OpeningBook> book;
+        EvalWeights weights;
+        std::shared_ptr<const NnueNetwork> network;
+
+        bool hasClock() const { return baseMs > 0 || incrementMs > 0; }
+    };
+
+    std::optional<EngineConfig> parseEngine(const std::string& spec) {
+        EngineConfig config;
+        config.spec = spec;
+
+        std::stringstream stream(spec);
+        std::string item;
+        bool first = true;
+        bool limited = false;
+
+        while (std::getline(stream, item, ',')) {
+            if (first) {
+                first = false;
+                if (item == "minimax") config.kind = AiKind::Minimax;
+                else if (item == "mcts") config.kind = AiKind::Mcts;
+                else return std::nullopt;
+                continue;
+            }
+
+            auto equals = item.find('=');
+            if (equals == std::string::npos) return std::nullopt;
+            std::string key = item.substr(0, equals);
+            std::string value = item.substr(equals + 1);
+
+            if (key == "depth") {
+                config.depth = std::clamp(std::atoi(value.c_str()), 1, maxSearchDepth);
+                limited = true;
+            } else if (key == "movetime") {
+                config.moveTimeMs = std::atoi(value.c_str());
+                limited = true;
+            } else if (key == "tc") {
+                auto plus = value.find('+');
+                config.baseMs = std::atoi(value.substr(0, plus).c_str());
+                config.incrementMs = plus == std::string::npos ? 0 : std::atoi(value.substr(plus + 1).c_str());
+                limited = true;
+            } else if (key == "hash") {
+                config.hashMb = std::atoi(value.c_str());
+            } else if (key == "threads") {
+                config.threads = std::max(1, std::atoi(value.c_str()));
+            } else if (key == "iterations") {
+                config.iterations = std::atoi(value.c_str());
+                limited = true;
+            } else if (key == "policy") {
+                config.policy = value == "random" ? PlayoutPolicy::Random : PlayoutPolicy::Greedy;
+            } else if (key == "c") {
+                config.exploration = std::atof(value.c_str());
+            } else if (key == "nodes") {
+                config.mctsNodes = std::max(1024, std::atoi(value.c_str()));
+            } else if (key == "book") {
+                auto book = std::make_shared<OpeningBook>();
+                if (!book->open(value)) return std::nullopt;
+                config.book = book;
+            } else if (key == "eval") {
+                auto weights = readEvalWeights(value);
+                if (!weights) return std::nullopt;
+                config.weights = *weights;
+            } else if (key == "nnue") {
+                config.network = NnueNetwork::load(value);
+                if (!config.network) return std::nullopt;
+            } else {
+                return std::nullopt;
+            }
+        }
+
+        if (first) return std::nullopt;
+        if (!limited) config.moveTimeMs = 100;
+        return config;
+    }
+
+    // One engine instance, owned by a single worker thread.
+    class Player {
+    public:
+        explicit Player(const EngineConfig& config) : config(config) {
+            if (config.kind == AiKind::Mcts) {
+                mcts = std::make_unique<MctsEngine>(config.threads, config.mctsNodes);
+                mcts->setPlayoutPolicy(config.policy);
+                mcts->setExploration(config.exploration);
+                mcts->setOpeningBook(config.book);
+            } else {
+                engine = std::make_unique<Engine>(config.hashMb, config.threads);
+                engine->setOpeningBook(config.book);
+                engine->setEvalWeights(config.weights);
+                engine->setNetwork(config.network);
+            }
+        }
+
+        void newGame() {
+            if (engine) engine->clearHash();
+            if (mcts) mcts->clearTree();
+        }
+
+        Move think(const Position& position, int side, int timeMs) {
+            CellState player = Position::player(side);
+            if (engine) {
+                return engine->search(position, player, {config.depth, timeMs}).bestMove;
+            }
+            return mcts->search(position, player, {config.iterations, timeMs}).bestMove;
+        }
+
+    private:
+        EngineConfig config;
+        std::unique_ptr<Engine> engine;
+        std::unique_ptr<MctsEngine> mcts;
+    };
+
+    struct Opening {
+        Position position;
+        int side = 0;
+        std::vector<Move> moves;
+    };
+
+    std::optional<Opening> parseOpening(const Position& start, const std::string& line) {
+        Opening opening{start, 0, {}};
+        std::stringstream stream(line);
+        std::string token;
+
+        while (stream >> token) {
+            std::optional<Move> move = parseRecordedMove(opening.position, opening.side, token);
+            if (!move) return std::nullopt;
+
+            Undo undo;
+            opening.position.makeMove(opening.side, *move, undo);
+            opening.side ^= 1;
+            opening.moves.push_back(*move);
+        }
+        return opening;
+    }
+
+    Opening randomOpening(const Position& start, uint64_t seed, int plies) {
+        while (true) {
+            Opening opening{start, 0, {}};
+            for (int ply = 0; ply < plies && !opening.position.isGameOver(opening.side); ply++) {
+                MoveList moves;
+                opening.position.generateMoves(opening.side, moves);
+                Move move = moves.moves[Zobrist::splitmix64(seed) % moves.size];
+                Undo undo;
+                opening.position.makeMove(opening.side, move, undo);
+                opening.side ^= 1;
+                opening.moves.push_back(move);
+            }
+            if (!opening.position.isGameOver(opening.side)) return opening;
+        }
+    }
+
+    struct GameResult {
+        // for Player1: 1 win, 0 draw, -1 loss
+        int score = 0;
+        bool timeout = false;
+        // the side to move had no move to give, which only an engine bug explains
+        bool forfeit = false;
+        int plies = 0;
+        // from the standard layout, opening included
+        std::vector<Move> moves;
+    };
+
+    GameResult playGame(Player* players[2], const EngineConfig* configs[2], const Opening& opening, int maxPlies) {
+        using Clock = std::chrono::steady_clock;
+
+        // players[0] and configs[0] play Player1
+        Position position = opening.position;
+        int side = opening.side;
+        int clocks[2] = {configs[0]->baseMs, configs[1]->baseMs};
+        GameResult result;
+        result.moves = opening.moves;
+
+        players[0]->newGame();
+        players[1]->newGame();
+
+        for (; result.plies < maxPlies && !position.isGameOver(side); result.plies++) {
+            const EngineConfig& config = *configs[side];
+
+            int budget = config.moveTimeMs;
+            if (config.hasClock()) {
+                int share = clocks[side] / 20 + config.incrementMs;
+                budget = std::max(1, std::min(share, clocks[side] - 10));
+            }
+
+            auto start = Clock::now();
+            Move move = players[side]->think(position, side, budget);
+            int elapsed = static_cast<int>(std::chrono::duration_cast<std::chrono::milliseconds>(Clock::now() - start).count());
+
+            if (config.hasClock()) {
+                clocks[side] -= elapsed;
+                if (clocks[side] < 0) {
+                    result.timeout = true;
+                    result.score = side == 0 ? -1 : 1;
+                    return result;
+                }
+                clocks[side] += config.incrementMs;
+            }
+
+            if (!move.isValid()) {
+                result.forfeit = true;
+                result.score = side == 0 ? -1 : 1;
+                return result;
+            }
+
+            Undo undo;
+            position.makeMove(side, move, undo);
+            side ^= 1;
+            result.moves.push_back(move);
+        }
+
+        int margin = position.isGameOver(side) ? position.finalMargin(side)
+                                               : position.count(CellState::Player1) - position.count(CellState::Player2);
+        result.score = margin > 0 ? 1 : margin < 0 ? -1 : 0;
+        return result;
+    }
+
+    struct Tally {
+        int wins = 0;
+        int draws = 0;
+        int losses = 0;
+        int timeouts = 0;
+        int forfeits = 0;
+
+        int games() const { return wins + draws + losses; }
+        double score() const { return games() ? (wins + 0.5 * draws) / games() : 0.5; }
+        // Per-game variance of the score. One extra virtual draw keeps it above zero
+        // when every game so far ended the same way.
+        double variance() const {
+            double s = score();
+            return (wins * (1 - s) * (1 - s) + (draws + 1) * (0.5 - s) * (0.5 - s) + losses * s * s) / (games() + 1);
+        }
+    };
+
+    double scoreToElo(double score) {
+        score = std::clamp(score, 1e-6, 1 - 1e-6);
+        return -400.0 * std::log10(1.0 / score - 1.0);
+    }
+
+    double eloToScore(double elo) {
+        return 1.0 / (1.0 + std::pow(10.0, -elo / 400.0));
+    }
+
+    // Log-likelihood ratio of elo1 against elo0, normal approximation of the trinomial model.
+    double sprtLlr(const Tally& tally, double elo0, double elo1) {
+        double variance = tally.variance();
+        if (tally.games() == 0 || variance <= 0) return 0.0;
+        double s0 = eloToScore(elo0);
+        double s1 = eloToScore(elo1);
+        return tally.games() * (s1 - s0) * (2 * tally.score() - s0 - s1) / (2 * variance);
+    }
+
+    void printSummary(const Tally& tally, const char* prefix) {
+        double score = tally.score();
+        double margin = 1.96 * std::sqrt(tally.variance() / std::max(1, tally.games()));
+        double elo = scoreToElo(score);
+        double low = scoreToElo(score - margin);
+        double high = scoreToElo(score + margin);
+
+        std::printf("%sgames %d: +%d =%d -%d (%d on time, %d forfeited), score %.1f%%, elo %+.1f [%+.1f, %+.1f]\n", prefix,
+                    tally.games(), tally.wins, tally.draws, tally.losses, tally.timeouts, tally.forfeits, score * 100, elo, low, high);
+    }
+}
+
+int main(int argc, char** argv) {
+    std::optional<EngineConfig> configs[2];
+    int games = 200;
+    int concurrency = std::max(1, static_cast<int>(std::thread::hardware_concurrency()));
+    int randomPlies = 4;
+    int maxPlies = 400;
+    uint64_t seed = 1;
+    std::string openingsFile;
+    std::string saveGamesFile;
+    Position startPosition = startingPosition();
+    bool sprt = false;
+    double elo0 = 0;
+    double elo1 = 5;
+    double alpha = 0.05;
+    double beta = 0.05;
+
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        bool hasValue = i + 1 < argc;
+        if ((arg == "--engine1" || arg == "--engine2") && hasValue) {
+            configs[arg == "--engine1" ? 0 : 1] = parseEngine(argv[++i]);
+            if (!configs[arg == "--engine1" ? 0 : 1]) {
+                std::fprintf(stderr, "bad engine spec %s\n", argv[i]);
+                return 1;
+            }
+        } else if (arg == "--games" && hasValue) {
+            games = std::max(2, std::atoi(argv[++i]));
+        } else if (arg == "--concurrency" && hasValue) {
+            concurrency = std::max(1, std::atoi(argv[++i]));
+        } else if (arg == "--random-plies" && hasValue) {
+            randomPlies = std::max(0, std::atoi(argv[++i]));
+        } else if (arg == "--layout" && hasValue) {
+            auto layout = readLayoutFile(argv[++i]);
+            if (!layout) {
+                std::fprintf(stderr, "cannot read layout %s\n", argv[i]);
+                return 1;
+            }
+            startPosition = layout->position;
+        } else if (arg == "--openings" && hasValue) {
+            openingsFile = argv[++i];
+        } else if (arg == "--save-games" && hasValue) {
+            saveGamesFile = argv[++i];
+        } else if (arg == "--max-plies" && hasValue) {
+            maxPlies = std::max(1, std::atoi(argv[++i]));
+        } else if (arg == "--seed" && hasValue) {
+            seed = std::strtoull(argv[++i], nullptr, 10);
+        } else if (arg == "--sprt" && i + 2 < argc) {
+            sprt = true;
+            elo0 = std::atof(argv[++i]);
+            elo1 = std::atof(argv[++i]);
+        } else if (arg == "--alpha" && hasValue) {
+            alpha = std::atof(argv[++i]);
+        } else if (arg == "--beta" && hasValue) {
+            beta = std::atof(argv[++i]);
+        } else {
+            std::fprintf(stderr, "usage: %s --engine1 spec --engine2 spec [--games N] [--concurrency N]\n"
+                                 "       [--layout file] [--random-plies N | --openings file] [--sprt elo0 elo1] [--seed N]\n", argv[0]);
+            return 1;
+        }
+    }
+
+    if (!configs[0] || !configs[1]) {
+        std::fprintf(stderr, "both --engine1 and --engine2 are required\n");
+        return 1;
+    }
+
+    std::vector<Opening> bookOpenings;
+    if (!openingsFile.empty()) {
+        std::ifstream file(openingsFile);
+        std::string line;
+        while (std::getline(file, line)) {
+            if (line.empty() || line[0] == '#') continue;
+            if (auto opening = parseOpening(startPosition, line)) {
+                bookOpenings.push_back(*opening);
+            } else {
+                std::fprintf(stderr, "skipping bad opening: %s\n", line.c_str());
+            }
+        }
+        if (bookOpenings.empty()) {
+            std::fprintf(stderr, "no openings in %s\n", openingsFile.c_str());
+            return 1;
+        }
+    }
+
+    double lowerBound = std::log(beta / (1 - alpha));
+    double upperBound = std::log((1 - beta) / alpha);
+
+    std::printf("engine1: %s\nengine2: %s\n", configs[0]->spec.c_str(), configs[1]->spec.c_str());
+    std::printf("%d games, %d at once\n", games, concurrency);
+
+    std::ofstream savedGames;
+    if (!saveGamesFile.empty()) {
+        savedGames.open(saveGamesFile, std::ios::app);
+        if (!savedGames.is_open()) {
+            std::fprintf(stderr, "cannot open %s\n", saveGamesFile.c_str());
+            return 1;
+        }
+    }
+
+    std::atomic<int> nextGame = 0;
+    std::atomic<bool> stop = false;
+    std::mutex tallyMutex;
+    Tally tally;
+    uint64_t totalPlies = 0;
+    const char* verdict = nullptr;
+
+    auto worker = [&] {
+        Player first(*configs[0]);
+        Player second(*configs[1]);
+
+        while (!stop) {
+            int game = nextGame.fetch_add(1);
+            if (game >= games) break;
+
+            // both games of a pair share the opening, the engines swap colours
+            int pair = game / 2;
+            Opening opening = bookOpenings.empty()
+                ? randomOpening(startPosition, seed * 0x9E3779B97F4A7C15ull + pair, randomPlies)
+                : bookOpenings[pair % bookOpenings.size()];
+
+            bool swapped = game % 2 == 1;
+            Player* players[2] = {&first, &second};
+            const EngineConfig* gameConfigs[2] = {&*configs[0], &*configs[1]};
+            if (swapped) {
+                std::swap(players[0], players[1]);
+                std::swap(gameConfigs[0], gameConfigs[1]);
+            }
+
+            GameResult result = playGame(players, gameConfigs, opening, maxPlies);
+            int score = swapped ? -result.score : result.score;
+
+            std::lock_guard lock(tallyMutex);
+            if (stop) break;
+            if (score > 0) tally.wins++;
+            else if (score < 0) tally.losses++;
+            else tally.draws++;
+            tally.timeouts += result.timeout;
+            tally.forfeits += result.forfeit;
+            totalPlies += result.plies;
+
+            if (savedGames.is_open()) {
+                savedGames << result.score;
+                for (const Move& move : result.moves) {
+                    savedGames << ' ' << int(move.from) << '-' << int(move.to);
+                }
+                savedGames << '\n';
+            }
+
+            if (tally.games() % 10 == 0) {
+                printSummary(tally, "");
+                if (sprt) std::printf("  llr %.2f [%.2f, %.2f]\n", sprtLlr(tally, elo0, elo1), lowerBound, upperBound);
+                std::fflush(stdout);
+            }
+
+            if (sprt && tally.games() % 2 == 0) {
+                double llr = sprtLlr(tally, elo0, elo1);
+                if (llr >= upperBound) verdict = "H1 accepted: engine1 is stronger by elo1";
+                if (llr <= lowerBound) verdict = "H0 accepted: engine1 is not stronger by elo1";
+                if (verdict) stop = true;
+            }
+        }
+    };
+
+    auto start = std::chrono::steady_clock::now();
+    std::vector<std::thread> threads;
+    for (int i = 0; i < concurrency; i++) {
+        threads.emplace_back(worker);
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    std::printf("\n");
+    printSummary(tally, "final: ");
+    std::printf("average game %.1f plies, %.1f s total\n", tally.games() ? double(totalPlies) / tally.games() : 0.0, seconds);
+    if (sprt) {
+        std::printf("sprt elo0 %.1f elo1 %.1f: llr %.2f [%.2f, %.2f], %s\n", elo0, elo1, sprtLlr(tally, elo0, elo1),
+                    lowerBound, upperBound, verdict ? verdict : "inconclusive");
+    }
+    return 0;
+}
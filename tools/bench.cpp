@@ -0,0 +1,381 @@
+// hexagon_bench: microbenchmarks for the hot paths, reported as JSON.
+//
+//   hexagon_bench [--filter text] [--min-time ms] [--out file]
+//
+// Every benchmark repeats its body in growing batches until a batch takes at least
+// --min-time, then reports the time per operation of that batch. Built with the GUI,
+// it also times a board's frame logic and pointer handling on a window that is never
+// opened, and the animation scheduler.
+
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "BoardState.h"
+#include "SaveFile.h"
+#include "ai.h"
+
+#ifdef HEXAGON_BENCH_BOARD
+#include "Board.h"
+#include "Tween.h"
+#endif
+
+namespace {
+    struct BenchResult {
+        std::string name;
+        uint64_t iterations = 0;
+        double nsPerOp = 0.0;
+        // benchmark specific numbers, already formatted as JSON members
+        std::string extra;
+    };
+
+    // keeps the optimizer from dropping the measured work
+    volatile uint64_t sink = 0;
+
+    double minTimeMs = 300.0;
+
+    BenchResult measure(const std::string& name, const std::function<uint64_t()>& body) {
+        using Clock = std::chrono::steady_clock;
+
+        uint64_t batch = 1;
+        while (true) {
+            auto start = Clock::now();
+            uint64_t total = 0;
+            for (uint64_t i = 0; i < batch; i++) {
+                total += body();
+            }
+            double elapsed = std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+            sink = sink + total;
+
+            if (elapsed >= minTimeMs || batch >= (uint64_t(1) << 40)) {
+                return {name, batch, elapsed * 1e6 / batch, ""};
+            }
+            batch *= elapsed > 0 ? std::max(2.0, std::min(100.0, 1.5 * minTimeMs / elapsed)) : 100;
+        }
+    }
+
+    // Positions from a fixed set of random games, so every run benchmarks the same boards.
+    std::vector<Position> samplePositions(int count) {
+        std::vector<Position> positions;
+        uint64_t seed = 0x62656E6368;
+
+        while (static_cast<int>(positions.size()) < count) {
+            Position position = startingPosition();
+            int side = 0;
+            for (int ply = 0; ply < 60 && !position.isGameOver(side); ply++) {
+                MoveList moves;
+                position.generateMoves(side, moves);
+                Undo undo;
+                position.makeMove(side, moves.moves[Zobrist::splitmix64(seed) % moves.size], undo);
+                side ^= 1;
+                if (ply % 6 == 5) positions.push_back(position);
+            }
+        }
+        positions.resize(count);
+        return positions;
+    }
+
+    std::string quoted(const std::string& text) {
+        return "\"" + text + "\"";
+    }
+}
+
+int main(int argc, char** argv) {
+    std::string filter;
+    std::string outFile;
+
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        if (arg == "--filter" && i + 1 < argc) {
+            filter = argv[++i];
+        } else if (arg == "--min-time" && i + 1 < argc) {
+            minTimeMs = std::max(1, std::atoi(argv[++i]));
+        } else if (arg == "--out" && i + 1 < argc) {
+            outFile = argv[++i];
+        } else {
+            std::cerr << "usage: " << argv[0] << " [--filter text] [--min-time ms] [--out file]" << std::endl;
+            return 1;
+        }
+    }
+
+    std::vector<Position> positions = samplePositions(64);
+    std::vector<BenchResult> results;
+
+    auto bench = [&](const std::string& name, const std::function<uint64_t()>& body) -> BenchResult* {
+        if (name.find(filter) == std::string::npos) return nullptr;
+        results.push_back(measure(name, body));
+        const BenchResult& result = results.back();
+        std::cerr << name << ": " << result.nsPerOp << " ns/op (" << result.iterations << " runs)" << std::endl;
+        return &results.back();
+    };
+
+    // one op = one call for every piece of the side to move, over all sample positions
+    bench("movegen/getAvailableForCloningCells", [&] {
+        uint64_t found = 0;
+        for (const Position& position : positions) {
+            BoardState board(position);
+            for (auto [row, col] : board.getCellsWithState(CellState::Player1)) {
+                found += board.getAvailableForCloningCells(row, col).size();
+            }
+        }
+        return found;
+    });
+
+    bench("movegen/getAvailableForMovingCells", [&] {
+        uint64_t found = 0;
+        for (const Position& position : positions) {
+            BoardState board(position);
+            for (auto [row, col] : board.getCellsWithState(CellState::Player1)) {
+                found += board.getAvailableForMovingCells(row, col).size();
+            }
+        }
+        return found;
+    });
+
+    bench("movegen/generateMoves", [&] {
+        uint64_t found = 0;
+        for (const Position& position : positions) {
+            MoveList moves;
+            position.generateMoves(0, moves);
+            found += moves.size;
+        }
+        return found;
+    });
+
+    bench("capture", [&] {
+        uint64_t captured = 0;
+        for (const Position& position : positions) {
+            BoardState board(position);
+            for (auto [row, col] : board.getCellsWithState(CellState::Player1)) {
+                captured += board.capture(row, col);
+            }
+        }
+        return captured;
+    });
+
+    // capture gain of every move of the side to move, one neighbour mask at a time
+    bench("capture/gain_per_move", [&] {
+        uint64_t gain = 0;
+        for (const Position& position : positions) {
+            MoveList moves;
+            position.generateMoves(0, moves);
+            for (const Move& move : moves) {
+                gain += popcount(Topology::of(move.to).neighborMask & position.pieces[1]);
+            }
+        }
+        return gain;
+    });
+
+    // the same gains from one bit-sliced count of every cell
+    bench("capture/neighborCounts", [&] {
+        uint64_t gain = 0;
+        for (const Position& position : positions) {
+            MoveList moves;
+            position.generateMoves(0, moves);
+            NeighborCounts captures = neighborCounts(position.pieces[1]);
+            for (const Move& move : moves) {
+                gain += captures.at(move.to);
+            }
+        }
+        return gain;
+    });
+
+    bench("getCellsWithState", [&] {
+        uint64_t cells = 0;
+        for (const Position& position : positions) {
+            BoardState board(position);
+            cells += board.getCellsWithState(CellState::Empty).size();
+            cells += board.getCellsWithState(CellState::Player1).size();
+            cells += board.getCellsWithState(CellState::Player2).size();
+        }
+        return cells;
+    });
+
+    // One engine for every run, its table cleared first so each search starts cold. Building an
+    // engine allocates and zeroes the table, and clearing it zeroes it again; both are timed on
+    // their own so the search number is the search alone, less one clear.
+    bench("search/engine_setup", [&] {
+        Engine engine;
+        return static_cast<uint64_t>(engine.getThreads());
+    });
+
+    Engine engine;
+    bench("search/clearHash", [&] {
+        engine.clearHash();
+        return uint64_t(1);
+    });
+
+    constexpr int searchDepth = 6;
+    // nodes of every run, so the rate comes from the batch that was timed
+    std::vector<uint64_t> runNodes;
+    int searchedDepth = 0;
+    if (auto* result = bench("search/depth6", [&] {
+        engine.clearHash();
+        SearchResult search = engine.search(startingPosition(), CellState::Player1, {searchDepth});
+        runNodes.push_back(search.nodes);
+        searchedDepth = search.depth;
+        return static_cast<uint64_t>(search.bestMove.to);
+    })) {
+        uint64_t nodes = 0;
+        for (size_t i = runNodes.size() - result->iterations; i < runNodes.size(); i++) {
+            nodes += runNodes[i];
+        }
+        result->extra = "\"depth\": " + std::to_string(searchedDepth) + ", \"nodes\": " + std::to_string(nodes / result->iterations)
+            + ", \"nodes_per_second\": " + std::to_string(static_cast<uint64_t>(nodes * 1e9 / (result->nsPerOp * result->iterations)));
+    }
+
+    // Lazy SMP scaling: the same fixed-time search with more threads. The rate counts every
+    // thread's nodes; on fewer cores than threads the helpers only take turns with the main one.
+    constexpr int threadSearchMs = 200;
+    for (int threads : {1, 2, 4}) {
+        Engine threaded(TranspositionTable::defaultSizeMb, threads);
+        uint64_t threadNodes = 0;
+        double threadRate = 0;
+        int threadDepth = 0;
+        if (auto* result = bench("search/threads_" + std::to_string(threads), [&] {
+            threaded.clearHash();
+            SearchResult search = threaded.search(startingPosition(), CellState::Player1, {maxSearchDepth, threadSearchMs});
+            threadNodes = search.nodes;
+            threadRate = search.nodesPerSecond(search.nodes);
+            threadDepth = search.depth;
+            return static_cast<uint64_t>(search.bestMove.to);
+        })) {
+            result->extra = "\"depth\": " + std::to_string(threadDepth) + ", \"nodes\": " + std::to_string(threadNodes)
+                + ", \"nodes_per_second\": " + std::to_string(static_cast<uint64_t>(threadRate));
+        }
+    }
+
+    std::string savePath = (std::filesystem::temp_directory_path() / "hexagon_bench.sv").string();
+    bench("save/serialize_roundtrip", [&] {
+        uint64_t pieces = 0;
+        for (const Position& position : positions) {
+            SavedGame game;
+            game.position = position;
+            auto loaded = deserialize(serialize(game));
+            pieces += loaded ? loaded->position.count(CellState::Player1) : 0;
+        }
+        return pieces;
+    });
+
+    bench("save/file_roundtrip", [&] {
+        SavedGame game;
+        game.position = positions[sink % positions.size()];
+        writeSaveFile(game, savePath);
+        auto loaded = readSaveFile(savePath);
+        return static_cast<uint64_t>(loaded ? loaded->position.key : 0);
+    });
+    std::filesystem::remove(savePath);
+
+#ifdef HEXAGON_BENCH_BOARD
+    // the window is never opened, so nothing is drawn; this is the per-frame logic only
+    sf::RenderWindow window;
+    Board board(window, false);
+
+    // A frame while a move animates: every fade length a piece spawns, three pieces flip
+    // and the hover moves on, as after a real move. Captures only recolour pieces, so the
+    // board keeps its counts for the benchmarks below.
+    std::vector<Cell*> pieces;
+    for (auto& row : board.cells) {
+        for (Cell& cell : row) {
+            if (cell.getState() == CellState::Player1 || cell.getState() == CellState::Player2) pieces.push_back(&cell);
+        }
+    }
+    constexpr float frameTime = 1.0f / 60;
+    int frame = 0;
+    Cell* hovered = nullptr;
+    if (auto* result = bench("board/update_frame", [&] {
+        if (frame % 12 == 0) {
+            int move = frame / 12;
+            pieces[move % pieces.size()]->startSpawnAnimation();
+            for (int i = 1; i <= 3; i++) {
+                Cell& captured = *pieces[(move + i) % pieces.size()];
+                captured.captureBy(captured.getState());
+            }
+            if (hovered) hovered->setHovered(false);
+            hovered = pieces[move * 5 % pieces.size()];
+            hovered->setHovered(true);
+        }
+        frame++;
+        board.update(frameTime);
+        tweens().advance(frameTime);
+        return static_cast<uint64_t>(tweens().colors.size() + tweens().scalars.size());
+    })) {
+        result->extra = "\"live_tweens\": " + std::to_string(tweens().colors.size() + tweens().scalars.size());
+    }
+
+    // the scheduler alone with a fixed number of tweens that never finish
+    for (int count : {16, 256, 4096}) {
+        TweenScheduler scheduler;
+        std::vector<sf::Color> colors(count / 2);
+        std::vector<float> scalars(count - count / 2);
+        for (sf::Color& color : colors) scheduler.colors.start(&color, sf::Color::White, 1e9f);
+        for (float& scalar : scalars) scheduler.scalars.start(&scalar, 1.0f, 1e9f);
+        bench("tweens/advance_" + std::to_string(count), [&] {
+            scheduler.advance(frameTime);
+            return static_cast<uint64_t>(colors[0].r);
+        });
+    }
+
+    // A raster over the cells' bounding box and one column step around it, in steps that do not
+    // divide the cell spacing, so it lands on centres, edges and the gaps between cells alike.
+    // The unopened window puts the board at negative coordinates; the raster follows the cells.
+    BoardLayout layout = layoutOf(board.getPosition());
+    const Cell& origin = board.cells[0][0];
+    float columnStep = static_cast<float>(board.cells[0][1].getGlobalX() - origin.getGlobalX());
+    float rowStep = static_cast<float>(board.cells[1][0].getGlobalY() - origin.getGlobalY());
+    const Cell& last = board.cells[layout.rows - 1][layout.cols - 1];
+    std::vector<sf::Vector2i> sweep;
+    int hits = 0;
+    for (float y = origin.getGlobalY() - rowStep; y <= last.getGlobalY() + 1.5f * rowStep; y += rowStep / 6.3f) {
+        for (float x = origin.getGlobalX() - columnStep; x <= last.getGlobalX() + columnStep; x += columnStep / 5.7f) {
+            sf::Vector2i point(static_cast<int>(std::lround(x)), static_cast<int>(std::lround(y)));
+            sweep.push_back(point);
+            bool hit = false;
+            for (int row = 0; row < layout.rows && !hit; row++) {
+                for (int col = 0; col < layout.cols && !hit; col++) {
+                    hit = board.cells[row][col].contains(sf::Vector2f(point));
+                }
+            }
+            hits += hit;
+        }
+    }
+    size_t pointer = 0;
+    if (auto* result = bench("board/mouse_move", [&] {
+        pointer = (pointer + 1) % sweep.size();
+        board.handleEvent(sf::Event::MouseMoved{sweep[pointer]});
+        return static_cast<uint64_t>(pointer);
+    })) {
+        result->extra = "\"points\": " + std::to_string(sweep.size())
+            + ", \"hit_fraction\": " + std::to_string(static_cast<double>(hits) / sweep.size());
+    }
+    bench("board/getCellsWithState", [&] {
+        return static_cast<uint64_t>(board.getCellsWithState(CellState::Empty).size());
+    });
+#endif
+
+    std::ostringstream json;
+    json << "{\n  \"benchmarks\": [\n";
+    for (size_t i = 0; i < results.size(); i++) {
+        const BenchResult& result = results[i];
+        json << "    {\"name\": " << quoted(result.name) << ", \"iterations\": " << result.iterations
+             << ", \"ns_per_op\": " << result.nsPerOp << ", \"ops_per_second\": " << 1e9 / result.nsPerOp;
+        if (!result.extra.empty()) json << ", " << result.extra;
+        json << "}" << (i + 1 < results.size() ? "," : "") << "\n";
+    }
+    json << "  ]\n}\n";
+
+    if (outFile.empty()) {
+        std::cout << json.str();
+    } else {
+        std::ofstream(outFile) << json.str();
+    }
+    return 0;
+}
@@ -0,0 +1,255 @@
+// hexagon-book: builds and inspects opening books.
+//
+//   hexagon-book --out book.bin [--plies 8] [--depth 6] [--width 2] [--margin 1] [--threads N] [--hash mb]
+//       Searches every move of each book position and keeps the best ones, level by level
+//       from the starting layout. A move counts as the first ply of the --depth search (at
+//       least 2), so its reply is searched one ply shallower. Moves within --margin pieces of
+//       the best are kept, at most --width per position, and only their replies are expanded
+//       further. Every thread has a --hash sized table (default 16 MB).
+//   hexagon-book --out book.bin --games games.txt [--plies 8] [--min-count 2]
+//       Counts the moves of recorded games (hexagon-arena --save-games), weighted by the
+//       points the mover scored with them.
+//   hexagon-book --dump book.bin
+//       Prints the records.
+//   --layout file builds the book for another starting layout than the standard board.
+
+#include <algorithm>
+#include <atomic>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <map>
+#include <mutex>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <unordered_set>
+#include <vector>
+
+#include "Layout.h"
+#include "OpeningBook.h"
+#include "SaveFile.h"
+#include "ai.h"
+
+namespace {
+    struct Node {
+        Position position;
+        int side = 0;
+    };
+
+    uint64_t keyOf(const Node& node) {
+        return node.position.key ^ Zobrist::sideKey(node.side);
+    }
+
+    BookEntry makeEntry(uint64_t key, const Move& move, int weight, int score) {
+        BookEntry entry;
+        entry.key = key;
+        entry.from = move.from;
+        entry.to = move.to;
+        entry.type = move.type;
+        entry.weight = static_cast<uint16_t>(std::clamp(weight, 1, 0xFFFF));
+        entry.score = static_cast<int16_t>(std::clamp(score, -0x7FFF, 0x7FFF));
+        return entry;
+    }
+
+    std::vector<BookEntry> buildFromSearch(const Position& start, int plies, int depth, int width, int margin, int threads,
+                                           int hashMb) {
+        std::vector<BookEntry> records;
+        std::vector<Node> frontier = {{start, 0}};
+        std::unordered_set<uint64_t> seen = {keyOf(frontier[0])};
+
+        for (int ply = 0; ply < plies && !frontier.empty(); ply++) {
+            std::vector<Node> next;
+            std::atomic<size_t> nextIndex = 0;
+            std::mutex resultMutex;
+
+            auto worker = [&] {
+                Engine engine(hashMb, 1);
+                while (true) {
+                    size_t index = nextIndex.fetch_add(1);
+                    if (index >= frontier.size()) return;
+                    const Node& node = frontier[index];
+
+                    MoveList moves;
+                    node.position.generateMoves(node.side, moves);
+
+                    // every reply gets the same search, so their scores compare directly
+                    std::vector<std::pair<int, Move>> scored;
+                    for (const Move& move : moves) {
+                        Position child = node.position;
+                        Undo undo;
+                        child.makeMove(node.side, move, undo);
+
+                        int score;
+                        if (child.isGameOver(node.side ^ 1)) {
+                            int margin = child.finalMargin(node.side ^ 1);
+                            if (node.side == 1) margin = -margin;
+                            score = margin > 0 ? winScore : margin < 0 ? -winScore : 0;
+                        } else {
+                            SearchResult result = engine.search(child, Position::player(node.side ^ 1), {depth - 1});
+                            score = -result.score;
+                        }
+                        scored.push_back({score, move});
+                    }
+
+                    std::stable_sort(scored.begin(), scored.end(),
+                                     [](const auto& a, const auto& b) { return a.first > b.first; });
+
+                    std::lock_guard lock(resultMutex);
+                    for (int i = 0; i < static_cast<int>(scored.size()) && i < width; i++) {
+                        auto [score, move] = scored[i];
+                        int behind = (scored[0].first - score) / pieceScore;
+                        if (behind > margin) break;
+
+                        // each piece behind the best move halves the weight
+                        records.push_back(makeEntry(keyOf(node), move, 256 >> std::min(behind, 8), score));
+
+                        Node child = node;
+                        Undo undo;
+                        child.position.makeMove(child.side, move, undo);
+                        child.side ^= 1;
+                        if (!child.position.isGameOver(child.side) && seen.insert(keyOf(child)).second) {
+                            next.push_back(child);
+                        }
+                    }
+                }
+            };
+
+            std::vector<std::thread> pool;
+            for (int i = 0; i < threads; i++) {
+                pool.emplace_back(worker);
+            }
+            for (auto& thread : pool) {
+                thread.join();
+            }
+
+            std::fprintf(stderr, "ply %d: %zu positions, %zu records\n", ply + 1, frontier.size(), records.size());
+            frontier = std::move(next);
+        }
+        return records;
+    }
+
+    std::vector<BookEntry> buildFromGames(const Position& start, const std::string& path, int plies, int minCount) {
+        struct Tally {
+            int count = 0;
+            // two per win and one per draw for the side that played the move
+            int points = 0;
+        };
+        std::map<std::pair<uint64_t, uint32_t>, Tally> moves;
+
+        std::ifstream file(path);
+        std::string line;
+        int games = 0;
+        while (std::getline(file, line)) {
+            std::stringstream stream(line);
+            int result;
+            if (!(stream >> result)) continue;
+            games++;
+
+            Node node{start, 0};
+            std::string token;
+            for (int ply = 0; ply < plies && stream >> token; ply++) {
+                std::optional<Move> found = parseRecordedMove(node.position, node.side, token);
+                if (!found) break;
+
+                Move move = *found;
+                Tally& tally = moves[{keyOf(node), move.from | move.to << 8 | static_cast<uint32_t>(move.type) << 16}];
+                int mover = node.side == 0 ? result : -result;
+                tally.count++;
+                tally.points += mover + 1;
+
+                Undo undo;
+                node.position.makeMove(node.side, move, undo);
+                node.side ^= 1;
+            }
+        }
+        std::fprintf(stderr, "%d games, %zu distinct moves\n", games, moves.size());
+
+        std::vector<BookEntry> records;
+        for (const auto& [id, tally] : moves) {
+            if (tally.count < minCount || tally.points == 0) continue;
+            Move move{static_cast<uint8_t>(id.second & 0xFF), static_cast<uint8_t>(id.second >> 8 & 0xFF),
+                      static_cast<MoveType>(id.second >> 16)};
+            // the move's expected result for its side, in search units like a searched book
+            int score = scoreForExpectedResult(tally.points / (2.0 * tally.count));
+            records.push_back(makeEntry(id.first, move, tally.points, score));
+        }
+        return records;
+    }
+
+    void dump(const OpeningBook& book) {
+        std::printf("%zu records\n", book.size());
+        for (const BookEntry& entry : book.records()) {
+            std::printf("%016llx %s %d-%d weight %d score %d\n", static_cast<unsigned long long>(entry.key),
+                        entry.type == MoveType::Clone ? "clone" : "jump ", entry.from, entry.to, entry.weight, entry.score);
+        }
+    }
+}
+
+int main(int argc, char** argv) {
+    std::string out;
+    std::string games;
+    std::string dumpPath;
+    int plies = 8;
+    int depth = 6;
+    int width = 2;
+    int margin = 1;
+    int minCount = 2;
+    int threads = std::max(1, static_cast<int>(std::thread::hardware_concurrency()));
+    int hashMb = TranspositionTable::defaultSizeMb;
+    Position startPosition = startingPosition();
+
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        bool hasValue = i + 1 < argc;
+        if (arg == "--out" && hasValue) out = argv[++i];
+        else if (arg == "--games" && hasValue) games = argv[++i];
+        else if (arg == "--dump" && hasValue) dumpPath = argv[++i];
+        else if (arg == "--plies" && hasValue) plies = std::max(1, std::atoi(argv[++i]));
+        // the replies are searched one ply shallower, and a depth 0 search scores nothing
+        else if (arg == "--depth" && hasValue) depth = std::clamp(std::atoi(argv[++i]), 2, maxSearchDepth - 1);
+        else if (arg == "--width" && hasValue) width = std::max(1, std::atoi(argv[++i]));
+        else if (arg == "--margin" && hasValue) margin = std::max(0, std::atoi(argv[++i]));
+        else if (arg == "--min-count" && hasValue) minCount = std::max(1, std::atoi(argv[++i]));
+        else if (arg == "--threads" && hasValue) threads = std::max(1, std::atoi(argv[++i]));
+        else if (arg == "--hash" && hasValue) hashMb = std::max(0, std::atoi(argv[++i]));
+        else if (arg == "--layout" && hasValue) {
+            auto layout = readLayoutFile(argv[++i]);
+            if (!layout) {
+                std::fprintf(stderr, "cannot read layout %s\n", argv[i]);
+                return 1;
+            }
+            startPosition = layout->position;
+        } else {
+            std::fprintf(stderr, "usage: %s --out book.bin [--games file] [--plies N] [--depth N] [--width N]\n"
+                                 "       [--margin N] [--min-count N] [--threads N] [--hash mb] [--layout file] | --dump book.bin\n", argv[0]);
+            return 1;
+        }
+    }
+
+    if (!dumpPath.empty()) {
+        OpeningBook book;
+        if (!book.open(dumpPath)) {
+            std::fprintf(stderr, "cannot open book %s\n", dumpPath.c_str());
+            return 1;
+        }
+        dump(book);
+        return 0;
+    }
+
+    if (out.empty()) {
+        std::fprintf(stderr, "--out is required\n");
+        return 1;
+    }
+
+    std::vector<BookEntry> records = games.empty()
+        ? buildFromSearch(startPosition, plies, depth, width, margin, threads, hashMb)
+        : buildFromGames(startPosition, games, plies, minCount);
+
+    if (!OpeningBook::write(out, records)) {
+        std::fprintf(stderr, "cannot write %s\n", out.c_str());
+        return 1;
+    }
+    std::fprintf(stderr, "wrote %zu records to %s\n", records.size(), out.c_str());
+    return 0;
+}
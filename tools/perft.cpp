@@ -0,0 +1,286 @@
+// hexagon-perft: counts leaf positions to a fixed depth and checks move generation.
+//
+//   hexagon-perft [depth] [--load board_save.sv | --layout file] [--validate]
+//
+// Clones into the same cell lead to the same position and are counted once, as the
+// search generates them. --validate compares, at every node, Position::generateMoves,
+// the BoardState coordinate API and a plain array-based reference written after the
+// original Board code, including the board after every move.
+
+#include <algorithm>
+#include <cctype>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <set>
+#include <string>
+#include <utility>
+
+#include "BoardState.h"
+#include "Layout.h"
+#include "Position.h"
+#include "SaveFile.h"
+
+namespace {
+    using Cell = std::pair<int, int>;
+
+    constexpr int rows = BoardGeometry::rows;
+    constexpr int cols = BoardGeometry::cols;
+
+    // Straightforward 2D-array board using the same neighbour arithmetic as the GUI did
+    // before bitboards, kept slow on purpose.
+    struct ReferenceBoard {
+        CellState cells[rows][cols];
+
+        explicit ReferenceBoard(const Position& position) {
+            for (int row = 0; row < rows; row++) {
+                for (int col = 0; col < cols; col++) {
+                    cells[row][col] = position.getState(cellIndex(row, col));
+                }
+            }
+        }
+
+        bool isEmpty(int y, int x) const { return cells[y][x] == CellState::Empty; }
+
+        std::set<Cell> cloneTargets(int y, int x) const {
+            std::set<Cell> targets;
+            if (y - 1 >= 0 && isEmpty(y - 1, x)) targets.insert({y - 1, x});
+            if (y + 1 < rows && isEmpty(y + 1, x)) targets.insert({y + 1, x});
+            if (x + 1 < cols && isEmpty(y, x + 1)) targets.insert({y, x + 1});
+            if (x - 1 >= 0 && isEmpty(y, x - 1)) targets.insert({y, x - 1});
+            int dy = (x % 2 == 0) ? -1 : 1;
+            if (y + dy >= 0 && y + dy < rows && x - 1 >= 0 && isEmpty(y + dy, x - 1)) targets.insert({y + dy, x - 1});
+            if (y + dy >= 0 && y + dy < rows && x + 1 < cols && isEmpty(y + dy, x + 1)) targets.insert({y + dy, x + 1});
+            return targets;
+        }
+
+        std::set<Cell> jumpTargets(int cy, int cx) const {
+            std::set<Cell> targets;
+            for (int x = cx - 1; x <= cx + 1; x++) {
+                if (x < 0 || x >= cols) continue;
+                int dy = (cx % 2 == 0 && x % 2 == 1) ? 1 : 0;
+                if (cy + 2 - dy < rows && isEmpty(cy + 2 - dy, x)) targets.insert({cy + 2 - dy, x});
+                dy = (cx % 2 == 1 && x % 2 == 0) ? 1 : 0;
+                if (cy - 2 + dy >= 0 && cy - 2 + dy < rows && isEmpty(cy - 2 + dy, x)) targets.insert({cy - 2 + dy, x});
+            }
+            for (int y = cy - 1; y <= cy + 1; y++) {
+                if (y < 0 || y >= rows) continue;
+                if (cx + 2 < cols && isEmpty(y, cx + 2)) targets.insert({y, cx + 2});
+                if (cx - 2 >= 0 && isEmpty(y, cx - 2)) targets.insert({y, cx - 2});
+            }
+            return targets;
+        }
+
+        // clone targets are keyed by target only, like Position::generateMoves
+        void moves(CellState player, std::set<Cell>& clones, std::set<std::pair<Cell, Cell>>& jumps) const {
+            for (int y = 0; y < rows; y++) {
+                for (int x = 0; x < cols; x++) {
+                    if (cells[y][x] != player) continue;
+                    for (const Cell& to : cloneTargets(y, x)) clones.insert(to);
+                    for (const Cell& to : jumpTargets(y, x)) jumps.insert({{y, x}, to});
+                }
+            }
+        }
+
+        void play(CellState player, Cell from, Cell to, bool jump) {
+            cells[to.first][to.second] = player;
+            if (jump) cells[from.first][from.second] = CellState::Empty;
+
+            CellState enemy = player == CellState::Player1 ? CellState::Player2 : CellState::Player1;
+            int y = to.first;
+            int x = to.second;
+            int dy = (x % 2 == 0) ? -1 : 1;
+            Cell around[6] = {{y - 1, x}, {y + 1, x}, {y, x + 1}, {y, x - 1}, {y + dy, x - 1}, {y + dy, x + 1}};
+            for (auto [ny, nx] : around) {
+                if (ny >= 0 && ny < rows && nx >= 0 && nx < cols && cells[ny][nx] == enemy) {
+                    cells[ny][nx] = player;
+                }
+            }
+        }
+
+        bool sameAs(const Position& position) const {
+            return *this == ReferenceBoard(position);
+        }
+
+        bool operator==(const ReferenceBoard& other) const {
+            return std::equal(&cells[0][0], &cells[0][0] + rows * cols, &other.cells[0][0]);
+        }
+    };
+
+    int errors = 0;
+
+    void report(const char* what, const Position& position, int side) {
+        if (++errors > 10) return;
+        std::printf("mismatch: %s (side %d)\n", what, side + 1);
+        for (int row = 0; row < rows; row++) {
+            for (int col = 0; col < cols; col++) {
+                std::printf("%d ", static_cast<int>(position.getState(cellIndex(row, col))));
+            }
+            std::printf("\n");
+        }
+    }
+
+    Cell toCell(int cell) { return {cellRow(cell), cellCol(cell)}; }
+
+    void validate(Position& position, int side, const MoveList& moves) {
+        CellState player = Position::player(side);
+        ReferenceBoard reference(position);
+
+        std::set<Cell> refClones;
+        std::set<std::pair<Cell, Cell>> refJumps;
+        reference.moves(player, refClones, refJumps);
+
+        std::set<Cell> clones;
+        std::set<std::pair<Cell, Cell>> jumps;
+        for (int i = 0; i < moves.size; i++) {
+            const Move& move = moves.moves[i];
+            if (move.type == MoveType::Clone) {
+                if (!clones.insert(toCell(move.to)).second) report("clone target generated twice", position, side);
+                if (position.getState(move.from) != player || !(Topology::of(move.from).neighborMask & cellBit(move.to))) {
+                    report("clone from a wrong cell", position, side);
+                }
+            } else {
+                jumps.insert({toCell(move.from), toCell(move.to)});
+            }
+        }
+        if (clones != refClones) report("generateMoves clones", position, side);
+        if (jumps != refJumps) report("generateMoves jumps", position, side);
+
+        // the coordinate API the GUI uses
+        BoardState state(position);
+        std::set<Cell> apiClones;
+        std::set<std::pair<Cell, Cell>> apiJumps;
+        for (const Cell& from : state.getCellsWithState(player)) {
+            auto cloneCells = state.getAvailableForCloningCells(from.first, from.second);
+            auto moveCells = state.getAvailableForMovingCells(from.first, from.second);
+            if (std::set<Cell>(cloneCells.begin(), cloneCells.end()) != reference.cloneTargets(from.first, from.second)) {
+                report("getAvailableForCloningCells", position, side);
+            }
+            if (std::set<Cell>(moveCells.begin(), moveCells.end()) != reference.jumpTargets(from.first, from.second)) {
+                report("getAvailableForMovingCells", position, side);
+            }
+            apiClones.insert(cloneCells.begin(), cloneCells.end());
+            for (const Cell& to : moveCells) apiJumps.insert({from, to});
+        }
+        if (apiClones != refClones || apiJumps != refJumps) report("BoardState moves", position, side);
+
+        for (int i = 0; i < moves.size; i++) {
+            const Move& move = moves.moves[i];
+            bool jump = move.type == MoveType::Move;
+
+            ReferenceBoard after = reference;
+            after.play(player, toCell(move.from), toCell(move.to), jump);
+
+            Position before = position;
+            Undo undo;
+            int gained = position.makeMove(side, move, undo);
+            if (!after.sameAs(position)) report("makeMove board", before, side);
+            if (position.key != position.computeKey()) report("makeMove key", before, side);
+            if (gained != position.count(player) - before.count(player)) report("makeMove gain", before, side);
+
+            // the GUI path: clone or move, then capture around the target
+            BoardState gui(before);
+            if (jump) {
+                gui.moveFromTo(cellRow(move.from), cellCol(move.from), cellRow(move.to), cellCol(move.to));
+            } else {
+                gui.cloneFromTo(cellRow(move.from), cellCol(move.from), cellRow(move.to), cellCol(move.to));
+            }
+            gui.capture(cellRow(move.to), cellCol(move.to));
+            if (!after.sameAs(gui.position) || gui.position.key != position.key) report("BoardState move and capture", before, side);
+
+            position.unmakeMove(side, undo);
+            if (position.pieces[0] != before.pieces[0] || position.pieces[1] != before.pieces[1] || position.key != before.key) report("unmakeMove", before, side);
+        }
+    }
+
+    bool validating = false;
+
+    uint64_t perft(Position& position, int side, int depth) {
+        if (position.isGameOver(side)) return 0;
+
+        MoveList moves;
+        position.generateMoves(side, moves);
+        if (validating) validate(position, side, moves);
+        if (depth == 1) return moves.size;
+
+        uint64_t nodes = 0;
+        for (const Move& move : moves) {
+            Undo undo;
+            position.makeMove(side, move, undo);
+            nodes += perft(position, side ^ 1, depth - 1);
+            position.unmakeMove(side, undo);
+        }
+        return nodes;
+    }
+
+    std::string moveName(const Move& move) {
+        char name[32];
+        std::snprintf(name, sizeof(name), "%s %d,%d-%d,%d", move.type == MoveType::Clone ? "clone" : "jump ",
+                      cellRow(move.from), cellCol(move.from), cellRow(move.to), cellCol(move.to));
+        return name;
+    }
+}
+
+int main(int argc, char** argv) {
+    int depth = 4;
+    Position position = startingPosition();
+    int side = 0;
+
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        if (arg == "--validate") {
+            validating = true;
+        } else if (arg == "--load" && i + 1 < argc) {
+            auto game = readSaveFile(argv[++i]);
+            if (!game) {
+                std::fprintf(stderr, "cannot read save %s\n", argv[i]);
+                return 1;
+            }
+            position = game->position;
+            side = game->isPlayer1Turn ? 0 : 1;
+        } else if (arg == "--layout" && i + 1 < argc) {
+            auto layout = readLayoutFile(argv[++i]);
+            if (!layout) {
+                std::fprintf(stderr, "cannot read layout %s\n", argv[i]);
+                return 1;
+            }
+            position = layout->position;
+            side = 0;
+        } else if (std::isdigit(static_cast<unsigned char>(arg[0]))) {
+            depth = std::max(1, std::atoi(arg.c_str()));
+        } else {
+            std::fprintf(stderr, "usage: %s [depth] [--load file | --layout file] [--validate]\n", argv[0]);
+            return 1;
+        }
+    }
+
+    auto start = std::chrono::steady_clock::now();
+
+    uint64_t total = 0;
+    if (!position.isGameOver(side)) {
+        MoveList moves;
+        position.generateMoves(side, moves);
+        if (validating) validate(position, side, moves);
+
+        for (const Move& move : moves) {
+            Undo undo;
+            position.makeMove(side, move, undo);
+            uint64_t nodes = depth > 1 ? perft(position, side ^ 1, depth - 1) : 1;
+            position.unmakeMove(side, undo);
+
+            std::printf("%s: %llu\n", moveName(move).c_str(), static_cast<unsigned long long>(nodes));
+            total += nodes;
+        }
+    }
+
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    std::printf("\ndepth %d, player %d to move\n", depth, side + 1);
+    std::printf("nodes %llu in %.3f s, %.0f nodes/s\n", static_cast<unsigned long long>(total), seconds,
+                seconds > 0 ? total / seconds : 0.0);
+
+    if (validating) {
+        std::printf("validation: %d mismatches\n", errors);
+        return errors ? 2 : 0;
+    }
+    return 0;
+}
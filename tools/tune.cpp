@@ -0,0 +1,247 @@
+// hexagon-tune: fits the evaluation weights to recorded game results (Texel tuning).
+//
+//   hexagon-tune --games games.txt [--games more.txt ...] --out eval.weights [--init eval.weights]
+//                [--skip-plies 8] [--epochs 300] [--rate 1.0] [--threads N] [--layout file]
+//       Replays every game written by hexagon-arena --save-games and keeps each position after
+//       the first --skip-plies. A logistic of the evaluation is fitted to the game results by
+//       full-batch gradient descent (Adam), each thread summing the gradient over its share of
+//       the positions. The scale of the logistic is fitted once to the starting weights.
+//       Games played from another layout need that layout passed with --layout.
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <exception>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "Evaluation.h"
+#include "Layout.h"
+#include "SaveFile.h"
+
+namespace {
+    struct Sample {
+        // terms from Player1's point of view, whoever is to move
+        std::array<int16_t, evalTermCount> features;
+        // 1 - Player1 won, 0.5 - draw, 0 - Player2 won
+        float result;
+    };
+
+    using Gradient = std::array<double, evalTermCount>;
+
+    size_t loadGames(const Position& start, const std::string& path, int skipPlies, std::vector<Sample>& samples) {
+        std::ifstream file(path);
+        std::string line;
+        size_t games = 0;
+        while (std::getline(file, line)) {
+            std::stringstream stream(line);
+            int result;
+            if (!(stream >> result)) continue;
+            games++;
+
+            Position position = start;
+            int side = 0;
+            std::string token;
+            for (int ply = 0; stream >> token; ply++) {
+                std::optional<Move> found = parseRecordedMove(position, side, token);
+                if (!found) break;
+
+                if (ply >= skipPlies) {
+                    EvalFeatures features = evalFeatures(position, side);
+                    Sample sample;
+                    for (int term = 0; term < evalTermCount; term++) {
+                        sample.features[term] = static_cast<int16_t>(side == 0 ? features[term] : -features[term]);
+                    }
+                    sample.result = (result + 1) * 0.5f;
+                    samples.push_back(sample);
+                }
+
+                Undo undo;
+                position.makeMove(side, *found, undo);
+                side ^= 1;
+            }
+        }
+        return games;
+    }
+
+    double predict(const Sample& sample, const std::array<double, evalTermCount>& weights, double scale) {
+        double score = 0.0;
+        for (int term = 0; term < evalTermCount; term++) {
+            score += weights[term] * sample.features[term];
+        }
+        return 1.0 / (1.0 + std::exp(-scale * score));
+    }
+
+    // Mean squared error over the samples; with gradient set, also its gradient by the weights.
+    double meanError(const std::vector<Sample>& samples, const std::array<double, evalTermCount>& weights,
+                     double scale, int threads, Gradient* gradient) {
+        std::vector<double> errors(threads, 0.0);
+        std::vector<Gradient> partials(threads, Gradient{});
+
+        auto worker = [&](int id) {
+            size_t begin = samples.size() * id / threads;
+            size_t end = samples.size() * (id + 1) / threads;
+            for (size_t i = begin; i < end; i++) {
+                const Sample& sample = samples[i];
+                double p = predict(sample, weights, scale);
+                double diff = p - sample.result;
+                errors[id] += diff * diff;
+
+                if (gradient) {
+                    double slope = 2.0 * diff * p * (1.0 - p) * scale;
+                    for (int term = 0; term < evalTermCount; term++) {
+                        partials[id][term] += slope * sample.features[term];
+                    }
+                }
+            }
+        };
+
+        std::vector<std::thread> pool;
+        for (int id = 1; id < threads; id++) {
+            pool.emplace_back(worker, id);
+        }
+        worker(0);
+        for (auto& thread : pool) {
+            thread.join();
+        }
+
+        double error = 0.0;
+        if (gradient) gradient->fill(0.0);
+        for (int id = 0; id < threads; id++) {
+            error += errors[id];
+            if (gradient) {
+                for (int term = 0; term < evalTermCount; term++) {
+                    (*gradient)[term] += partials[id][term] / samples.size();
+                }
+            }
+        }
+        return error / samples.size();
+    }
+
+    // Golden-section search for the logistic scale that best fits the starting weights.
+    double fitScale(const std::vector<Sample>& samples, const std::array<double, evalTermCount>& weights, int threads) {
+        double low = 1e-4;
+        double high = 0.1;
+        const double ratio = (std::sqrt(5.0) - 1.0) / 2.0;
+        for (int i = 0; i < 40; i++) {
+            double a = high - ratio * (high - low);
+            double b = low + ratio * (high - low);
+            if (meanError(samples, weights, a, threads, nullptr) < meanError(samples, weights, b, threads, nullptr)) {
+                high = b;
+            } else {
+                low = a;
+            }
+        }
+        return (low + high) / 2.0;
+    }
+}
+
+int main(int argc, char** argv) {
+    std::vector<std::string> gameFiles;
+    std::string out;
+    std::string init;
+    int skipPlies = 8;
+    int epochs = 300;
+    double rate = 1.0;
+    int threads = std::max(1, static_cast<int>(std::thread::hardware_concurrency()));
+    Position startPosition = startingPosition();
+
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        bool hasValue = i + 1 < argc;
+        if (arg == "--games" && hasValue) gameFiles.push_back(argv[++i]);
+        else if (arg == "--out" && hasValue) out = argv[++i];
+        else if (arg == "--init" && hasValue) init = argv[++i];
+        else if (arg == "--skip-plies" && hasValue) skipPlies = std::max(0, std::atoi(argv[++i]));
+        else if (arg == "--epochs" && hasValue) epochs = std::max(1, std::atoi(argv[++i]));
+        else if (arg == "--rate" && hasValue) rate = std::atof(argv[++i]);
+        else if (arg == "--threads" && hasValue) threads = std::max(1, std::atoi(argv[++i]));
+        else if (arg == "--layout" && hasValue) {
+            auto layout = readLayoutFile(argv[++i]);
+            if (!layout) {
+                std::fprintf(stderr, "cannot read layout %s\n", argv[i]);
+                return 1;
+            }
+            startPosition = layout->position;
+        } else {
+            std::fprintf(stderr, "usage: %s --games file [--games file ...] --out eval.weights [--init eval.weights]\n"
+                                 "       [--skip-plies N] [--epochs N] [--rate R] [--threads N] [--layout file]\n", argv[0]);
+            return 1;
+        }
+    }
+
+    if (gameFiles.empty() || out.empty()) {
+        std::fprintf(stderr, "--games and --out are required\n");
+        return 1;
+    }
+
+    EvalWeights start;
+    if (!init.empty()) {
+        auto loaded = readEvalWeights(init);
+        if (!loaded) {
+            std::fprintf(stderr, "cannot read weights %s\n", init.c_str());
+            return 1;
+        }
+        start = *loaded;
+    }
+
+    std::vector<Sample> samples;
+    for (const std::string& path : gameFiles) {
+        size_t games = loadGames(startPosition, path, skipPlies, samples);
+        std::fprintf(stderr, "%s: %zu games\n", path.c_str(), games);
+    }
+    if (samples.empty()) {
+        std::fprintf(stderr, "no positions to tune on\n");
+        return 1;
+    }
+
+    std::array<double, evalTermCount> weights;
+    for (int term = 0; term < evalTermCount; term++) {
+        weights[term] = start.values[term];
+    }
+
+    double scale = fitScale(samples, weights, threads);
+    std::fprintf(stderr, "%zu positions, scale %.6f, error %.6f\n", samples.size(), scale,
+                 meanError(samples, weights, scale, threads, nullptr));
+
+    // Adam keeps the step size in weight units whatever the size of each term's gradient.
+    const double beta1 = 0.9;
+    const double beta2 = 0.999;
+    Gradient moment{};
+    Gradient velocity{};
+    for (int epoch = 1; epoch <= epochs; epoch++) {
+        Gradient gradient;
+        double error = meanError(samples, weights, scale, threads, &gradient);
+
+        for (int term = 0; term < evalTermCount; term++) {
+            moment[term] = beta1 * moment[term] + (1 - beta1) * gradient[term];
+            velocity[term] = beta2 * velocity[term] + (1 - beta2) * gradient[term] * gradient[term];
+            double corrected = moment[term] / (1 - std::pow(beta1, epoch));
+            double spread = std::sqrt(velocity[term] / (1 - std::pow(beta2, epoch)));
+            weights[term] -= rate * corrected / (spread + 1e-12);
+        }
+
+        if (epoch % 25 == 0 || epoch == epochs) {
+            std::fprintf(stderr, "epoch %d: error %.6f\n", epoch, error);
+        }
+    }
+
+    EvalWeights tuned;
+    for (int term = 0; term < evalTermCount; term++) {
+        tuned.values[term] = static_cast<int>(std::lround(weights[term]));
+        std::printf("%-16s %5d -> %5d\n", evalTermName(static_cast<EvalTerm>(term)), start.values[term], tuned.values[term]);
+    }
+
+    try {
+        writeEvalWeights(tuned, out);
+    } catch (const std::exception& error) {
+        std::fprintf(stderr, "%s\n", error.what());
+        return 1;
+    }
+    return 0;
+}